@@ -0,0 +1,177 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <ctime>
+#include "http/ResponseBuilder.hpp"
+#include "http/Status.hpp"
+
+/*
+	Microbenchmark: responses built per second
+
+	Compares ResponseBuilder::build(out, ...) (precomputed status line and
+	fixed headers, one reserve(), written into a reused send buffer, Date
+	cached by Clock) with the previous builder, reproduced below:
+	stringstream, copy of resp.headers into a new map, strftime() per
+	response, str(), then a copy into send_buffer.
+
+	Responses:
+		- small-200 : 200 + Content-Type, 2 KB body (CSS-like asset)
+		- error-404 : 404 + Content-Type, 1.2 KB HTML page
+		- redirect  : 301 + Location, no body
+		- large-200 : 200 + Content-Type, 1 MB body
+		- cached-200: file cache hit, body copied into resp then built
+		  (before) vs prebuilt response shared with the cache
+
+	Build (from the repo root):
+		c++ -O2 -std=c++98 -Iinclude "extra tests/Nico/bench_response_builder.cpp" \
+			src/http/ResponseBuilder7.cpp src/http/HttpResponse.cpp src/network/Clock.cpp -o bench_response_builder
+*/
+
+static double	nowSeconds()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+// Previous buildDateValue(): time() + gmtime_r() + strftime() per response
+static std::string	legacyDate()
+{
+	std::time_t	now = std::time(NULL);
+	std::tm		tmv;
+	char		buf[128];
+
+	if (gmtime_r(&now, &tmv) == NULL)
+		return ("");
+	std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tmv);
+	return (std::string(buf));
+}
+
+// Previous ResponseBuilder::build()
+static std::string	legacyBuild(const HttpResponse &resp, bool closeConnection)
+{
+	std::stringstream	ss;
+
+	ss	<< "HTTP/1.1 " << toStringSize(resp.statusCode) << " " << resp.reason << CRLF;
+	if (closeConnection)
+		ss << "Connection: close" << CRLF;
+	else
+		ss << "Connection: keep-alive" << CRLF;
+	StringMap	h = resp.headers;
+	h["Date"] = legacyDate();
+	h["Server"] = "webserv";
+	h["Content-Length"] = toStringSize(resp.body.size());
+	for (StringMap::const_iterator it = h.begin(); it != h.end(); ++it)
+		ss << it->first << ": " << it->second << CRLF;
+	ss << CRLF;
+	ss << resp.body;
+	return (ss.str());
+}
+
+static void	run(const char *name, const HttpResponse &resp, int iterations)
+{
+	std::string	sendBuffer;
+	size_t		bytes = 0;
+	double		t0;
+	double		legacy;
+	double		current;
+
+	t0 = nowSeconds();
+	for (int i = 0; i < iterations; i++)
+	{
+		sendBuffer = legacyBuild(resp, false);	// as in Server::processRequest()
+		bytes += sendBuffer.size();
+		sendBuffer.clear();						// as in Connection::write_pending()
+	}
+	legacy = nowSeconds() - t0;
+	std::string	legacyOut = legacyBuild(resp, false);
+
+	t0 = nowSeconds();
+	for (int i = 0; i < iterations; i++)
+	{
+		ResponseBuilder::build(sendBuffer, resp, false);
+		bytes += sendBuffer.size();
+		sendBuffer.clear();
+	}
+	current = nowSeconds() - t0;
+	ResponseBuilder::build(sendBuffer, resp, false);
+
+	// Same bytes, header order apart: compare sizes
+	std::cout << name << ": legacy=" << static_cast<long>(iterations / legacy) << " resp/s"
+			  << " builder=" << static_cast<long>(iterations / current) << " resp/s"
+			  << " speedup=x" << (current > 0 ? legacy / current : 0)
+			  << ((legacyOut.size() == sendBuffer.size() && bytes > 0) ? "" : "  [MISMATCH]") << std::endl;
+}
+
+/*
+	File cache hit: before, the cached body was copied into resp.body,
+	then build() wrote headers and body into the send buffer. Now the
+	entry keeps the serialized response (prebuilt): build() writes the
+	status line, Connection and Date, the body is shared, not copied.
+*/
+static void	runPrebuilt(const char *name, const HttpResponse &file, int iterations)
+{
+	std::string	sendBuffer;
+	std::string	bytes;
+	size_t		total = 0;
+	double		t0;
+	double		copy;
+	double		shared;
+
+	ResponseBuilder::buildPrebuilt(bytes, file);
+	SharedBuffer	entry = SharedBuffer::adopt(bytes);
+
+	t0 = nowSeconds();
+	for (int i = 0; i < iterations; i++)
+	{
+		HttpResponse	resp(200, reasonPhrase(200));
+		resp.body = file.body;						// copie du body du cache
+		resp.headers = file.headers;
+		ResponseBuilder::build(sendBuffer, resp, false);
+		total += sendBuffer.size();
+		sendBuffer.clear();
+	}
+	copy = nowSeconds() - t0;
+
+	t0 = nowSeconds();
+	for (int i = 0; i < iterations; i++)
+	{
+		HttpResponse	resp(200, reasonPhrase(200));
+		resp.prebuilt = entry;
+		ResponseBuilder::build(sendBuffer, resp, false);
+		total += sendBuffer.size() + resp.prebuilt.size();
+		sendBuffer.clear();
+	}
+	shared = nowSeconds() - t0;
+
+	std::cout << name << ": copy=" << static_cast<long>(iterations / copy) << " resp/s"
+			  << " prebuilt=" << static_cast<long>(iterations / shared) << " resp/s"
+			  << " speedup=x" << (shared > 0 ? copy / shared : 0)
+			  << (total > 0 ? "" : "  [MISMATCH]") << std::endl;
+}
+
+int	main()
+{
+	HttpResponse	css(200, reasonPhrase(200), std::string(2048, 'c'));
+	css.headers["Content-Type"] = "text/css";
+	run("small-200", css, 500000);
+
+	HttpResponse	notFound(404, reasonPhrase(404), std::string(1258, 'h'));
+	notFound.headers["Content-Type"] = "text/html";
+	run("error-404", notFound, 500000);
+
+	HttpResponse	redirect("https://www.google.com/", 301, reasonPhrase(301));
+	run("redirect", redirect, 500000);
+
+	HttpResponse	large(200, reasonPhrase(200), std::string(1024 * 1024, 'x'));
+	large.headers["Content-Type"] = "application/octet-stream";
+	run("large-200", large, 2000);
+
+	HttpResponse	cached(200, reasonPhrase(200), std::string(2383, 'c'));
+	cached.headers["Content-Type"] = "text/css";
+	cached.headers["ETag"] = "\"6984aca4-94f\"";
+	runPrebuilt("cached-200", cached, 500000);
+
+	return (0);
+}
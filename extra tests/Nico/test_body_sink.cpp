@@ -0,0 +1,166 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "http/RequestParser.hpp"
+
+/*
+	Test program: request bodies streamed to a BodySink
+
+	1. waitForBodySink(): parse() stops after the headers, the body stays
+	   in the input until a sink is chosen
+	2. chunked body split in small reads: every byte reaches the sink
+	   exactly once, nothing is kept in getRequest().body
+	3. streamBodyToFile(): the file holds the body, uploadPath is set
+	4. limit: 413 as soon as the body reaches maxBodySize, the partial
+	   upload file is removed; an existing file being overwritten is kept
+	5. discardBody(): body read, dropped, bodyBytesRead still counted
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_body_sink.cpp" src/http/ByteScan.cpp src/http/HeaderTable.cpp \
+			src/http/NumberParse.cpp src/http/BodySink.cpp src/http/RequestParser*.cpp \
+			src/network/RecvBuffer.cpp src/utils.cpp -o test_body_sink
+*/
+
+static int	g_failures = 0;
+
+static void	check(const std::string &what, bool ok)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+// Sink de test: garde tout et compte les appels
+class CollectSink : public BodySink
+{
+public:
+	std::string	data;
+	int			writes;
+	bool		finished;
+
+	CollectSink() : data(), writes(0), finished(false) {}
+	bool	write(const char *d, size_t n) { data.append(d, n); writes++; return (true); }
+	bool	finish(HttpRequest &) { finished = true; return (true); }
+};
+
+static std::string	readFile(const std::string &path)
+{
+	std::ifstream		ifs(path.c_str(), std::ios::in | std::ios::binary);
+	std::ostringstream	oss;
+
+	oss << ifs.rdbuf();
+	return (oss.str());
+}
+
+static std::string	chunked(const std::string &body, size_t chunk)
+{
+	std::ostringstream	oss;
+
+	for (size_t off = 0; off < body.size(); off += chunk)
+	{
+		std::string part = body.substr(off, chunk);
+		oss << std::hex << part.size() << "\r\n" << part << "\r\n";
+	}
+	oss << "0\r\n\r\n";
+	return (oss.str());
+}
+
+int	main()
+{
+	std::string	body;
+	for (int i = 0; i < 5000; i++)
+		body += static_cast<char>('a' + i % 26);
+
+	// 1 + 2: pause after the headers, then chunked body fed 7 bytes at a time
+	{
+		HttpRequestParser	parser;
+		CollectSink			sink;
+		std::string			raw = chunked(body, 1000);
+
+		parser.waitForBodySink(true);
+		parser.feed("POST /up HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n" + raw.substr(0, 3));
+		check("paused after headers", parser.needsBodySink() && !parser.isDone());
+		check("body not consumed while paused", parser.hasBufferedData());
+
+		parser.streamBodyTo(&sink, 1000000);
+		parser.parse();
+		for (size_t off = 3; off < raw.size(); off += 7)
+			parser.feed(raw.substr(off, 7));
+		check("chunked done", parser.isDone() && !parser.hasError());
+		check("sink got the exact body", sink.data == body && sink.finished);
+		check("nothing kept in memory", parser.getRequest().body.empty());
+		check("bodyBytesRead", parser.getRequest().bodyBytesRead == body.size());
+		check("chunk data streamed before its end", sink.writes > 5);
+	}
+
+	// 3: upload file
+	{
+		HttpRequestParser	parser;
+		std::string			path = "/tmp/test_body_sink.bin";
+		std::ostringstream	head;
+
+		head << "POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: " << body.size() << "\r\n\r\n";
+		parser.waitForBodySink(true);
+		parser.feed(head.str());
+		check("file sink opened", parser.streamBodyToFile(path, 1000000));
+		parser.feed(body.substr(0, 100));
+		parser.feed(body.substr(100));
+		check("upload done", parser.isDone() && !parser.hasError());
+		check("file content", readFile(path) == body);
+		check("uploadPath set", parser.getRequest().uploadPath == path);
+		unlink(path.c_str());
+	}
+
+	// 4: limit (same rule as Router::exceedsMaxSize: size >= max -> 413)
+	{
+		HttpRequestParser	parser;
+		std::string			path = "/tmp/test_body_sink_limit.bin";
+
+		parser.waitForBodySink(true);
+		parser.feed("POST /up HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n");
+		parser.streamBodyToFile(path, 4000);
+		parser.feed(chunked(body, 1000));
+		check("413 past the limit", parser.hasError() && parser.getErrorStatus() == 413);
+		parser.reset();
+		check("partial upload removed", access(path.c_str(), F_OK) != 0);
+	}
+
+	// 4b: failed upload over an existing file: the file is left untouched
+	{
+		HttpRequestParser	parser;
+		std::string			path = "/tmp/test_body_sink_keep.bin";
+
+		{
+			std::ofstream	ofs(path.c_str());
+			ofs << "original";
+		}
+		parser.waitForBodySink(true);
+		parser.feed("POST /up HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n");
+		parser.streamBodyToFile(path, 4000);
+		parser.feed(chunked(body, 1000));
+		check("target untouched while streaming", readFile(path) == "original");
+		parser.reset();
+		check("existing file kept after 413", readFile(path) == "original");
+		unlink(path.c_str());
+	}
+
+	// 5: discard
+	{
+		HttpRequestParser	parser;
+
+		parser.waitForBodySink(true);
+		parser.feed("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\n\r\n");
+		parser.discardBody(static_cast<size_t>(-1));
+		parser.feed("hello");
+		check("discard done", parser.isDone() && parser.getRequest().body.empty()
+			&& parser.getRequest().bodyBytesRead == 5);
+	}
+
+	if (g_failures == 0)
+		std::cout << "OK: all body sink tests passed" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "http/ResponseBuilder.hpp"
+#include "http/Status.hpp"
+#include "network/Clock.hpp"
+
+/*
+	Test program: conditional GET building blocks
+
+	1. If-Modified-Since dates: the 3 formats of RFC 9110 5.6.7 give the
+	   same time, invalid values are rejected
+	2. Last-Modified: formatHttpDate() round trip
+	3. 304: validators, no Content-Length, no body
+
+	The If-None-Match / If-Modified-Since decision itself (Router::notModified())
+	is checked against the server, e.g.:
+		curl -si -H 'If-None-Match: "<etag of the 200>"' http://127.0.0.1:8080/assets/css/style.css
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_conditional_get.cpp" src/network/Clock.cpp \
+			src/http/ResponseBuilder7.cpp src/http/HttpResponse.cpp -o test_conditional_get
+*/
+
+static int	g_failures = 0;
+
+static void	check(const std::string &what, bool ok)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+static bool	parse(const char *s, time_t &t)
+{
+	return (Clock::parseHttpDate(s, std::strlen(s), t));
+}
+
+int	main()
+{
+	const time_t	expected = 784111777;	// Sun, 06 Nov 1994 08:49:37 GMT
+	time_t			t = 0;
+
+	// 1: formats
+	check("IMF-fixdate", parse("Sun, 06 Nov 1994 08:49:37 GMT", t) && t == expected);
+	check("RFC 850", parse("Sunday, 06-Nov-94 08:49:37 GMT", t) && t == expected);
+	check("asctime", parse("Sun Nov  6 08:49:37 1994", t) && t == expected);
+	check("garbage rejected", !parse("yesterday", t));
+	check("trailing bytes rejected", !parse("Sun, 06 Nov 1994 08:49:37 GMT; length=12", t));
+	check("empty rejected", !parse("", t));
+
+	// 2: Last-Modified
+	char	date[Clock::HTTP_DATE_LEN + 1];
+	check("format", Clock::formatHttpDate(expected, date)
+		&& std::string(date) == "Sun, 06 Nov 1994 08:49:37 GMT");
+	check("round trip", parse(date, t) && t == expected);
+
+	// 3: 304
+	HttpResponse	resp(304, reasonPhrase(304));
+	resp.headers["ETag"] = "\"11e0be-6984aca4-94f\"";
+	resp.headers["Last-Modified"] = date;
+	std::string		raw = ResponseBuilder::build(resp, false);
+	check("status line", raw.compare(0, 27, "HTTP/1.1 304 Not Modified\r\n") == 0);
+	check("validators", raw.find("ETag: \"11e0be-6984aca4-94f\"\r\n") != std::string::npos
+		&& raw.find("Last-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n") != std::string::npos);
+	check("no Content-Length", raw.find("Content-Length") == std::string::npos);
+	check("no body", raw.compare(raw.size() - 4, 4, "\r\n\r\n") == 0);
+
+	if (g_failures == 0)
+		std::cout << "OK: all conditional GET tests passed" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
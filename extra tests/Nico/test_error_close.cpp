@@ -0,0 +1,208 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <csignal>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/*
+	Test program: a request the parser rejects gets ONE error response,
+	then the connection is closed (socket level, against ./webserv).
+
+	The input the parser did not consume (rest of a head that is too big,
+	rest of a body...) must never be parsed again as new requests, and the
+	close must not reset the connection before the client read the response
+	(lingering close: the server reads and drops what is still coming).
+
+	1. request head bigger than the max total, never terminated -> one 431
+	2. start line longer than the max line (8K), no CRLF -> one 400
+	3. chunked body, chunk size line that never ends -> one 400
+	4. chunked body, trailer line that never ends -> one 431
+	5. chunked upload past max_size (1M), client keeps sending -> one 413,
+	   no upload file left behind
+
+	Build and run (from the repo root, after make):
+		c++ -std=c++98 "extra tests/Nico/test_error_close.cpp" -o test_error_close
+		./test_error_close
+	Starts ./webserv config/default.conf (port 8080 must be free).
+*/
+
+static const int	PORT = 8080;
+static const int	WAIT_MS = 3000;				// reponse + fermeture avant ce delai
+static const size_t	READ_MAX = 1024 * 1024;		// au-dela: boucle de reponses
+
+static int	g_failures = 0;
+
+static int	connectServer()
+{
+	int					fd = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in	addr;
+
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PORT);
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0)
+		return (fd);
+	if (fd >= 0)
+		close(fd);
+	return (-1);
+}
+
+// Envoie tout ce qui peut l'etre (le serveur peut fermer avant la fin)
+static void	sendAll(int fd, const std::string& data)
+{
+	size_t	off = 0;
+
+	while (off < data.size())
+	{
+		ssize_t n = send(fd, data.data() + off, data.size() - off, 0);
+		if (n <= 0)
+			return;
+		off += n;
+	}
+}
+
+/*
+	Lit jusqu'a EOF (ou erreur), WAIT_MS ou READ_MAX.
+	closed = le serveur a ferme la connexion, reset = par un RST (ECONNRESET)
+*/
+static std::string	readAll(int fd, bool& closed, bool& reset)
+{
+	std::string	data;
+	char		buf[16 * 1024];
+	int			waited = 0;
+
+	closed = false;
+	reset = false;
+	while (waited < WAIT_MS && data.size() < READ_MAX)
+	{
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, 100) == 0)
+		{
+			waited += 100;
+			continue;
+		}
+		ssize_t n = recv(fd, buf, sizeof(buf), 0);
+		if (n <= 0)
+		{
+			closed = true;
+			reset = (n < 0);
+			break;
+		}
+		data.append(buf, n);
+	}
+	return (data);
+}
+
+static size_t	countResponses(const std::string& data)
+{
+	size_t	count = 0;
+
+	for (size_t pos = data.find("HTTP/1.1 "); pos != std::string::npos;
+		 pos = data.find("HTTP/1.1 ", pos + 1))
+		count++;
+	return (count);
+}
+
+static void	check(const std::string& name, const std::string& request, const std::string& status)
+{
+	int	fd = connectServer();
+
+	if (fd < 0)
+	{
+		std::cout << "FAIL " << name << ": connect()" << std::endl;
+		g_failures++;
+		return;
+	}
+	sendAll(fd, request);
+
+	bool		closed;
+	bool		reset;
+	std::string	data = readAll(fd, closed, reset);
+	size_t		count = countResponses(data);
+	close(fd);
+
+	bool ok = closed && !reset && count == 1 && data.compare(9, status.size(), status) == 0;
+	std::cout << (ok ? "ok   " : "FAIL ") << name << ": " << count << " response(s)"
+			  << (count ? " " + data.substr(9, 3) : "")
+			  << (!closed ? ", still open" : reset ? ", reset" : ", closed") << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+int	main()
+{
+	signal(SIGPIPE, SIG_IGN);
+
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		int devnull = open("/dev/null", O_WRONLY);
+		dup2(devnull, STDOUT_FILENO);
+		dup2(devnull, STDERR_FILENO);
+		execl("./webserv", "./webserv", "config/default.conf", static_cast<char*>(NULL));
+		_exit(127);
+	}
+	int fd = -1;
+	for (int i = 0; i < 50 && fd < 0; i++)
+	{
+		usleep(100000);
+		fd = connectServer();
+	}
+	if (fd < 0)
+	{
+		std::cout << "FAIL: ./webserv is not listening on " << PORT << std::endl;
+		kill(pid, SIGKILL);
+		waitpid(pid, NULL, 0);
+		return (1);
+	}
+	close(fd);
+
+	// 1. tete de 40 KB (> 4 * 8K), derniere ligne jamais terminee
+	std::string head = "GET / HTTP/1.1\r\nHost: localhost\r\n";
+	while (head.size() < 40 * 1024)
+		head += "X-Fill: " + std::string(1000, 'a') + "\r\n";
+	check("unterminated head too big", head + "X-Last: aaaa", "431");
+
+	// 2. ligne de requete de 9 KB sans CRLF
+	check("start line too long", "GET /" + std::string(9 * 1024, 'A'), "400");
+
+	// 3. / 4. chunked: ligne de taille puis trailer sans fin
+	std::string chunked = "POST /upload/error_close.bin HTTP/1.1\r\nHost: localhost\r\n"
+		"Transfer-Encoding: chunked\r\n\r\n";
+	check("chunk size line too long", chunked + "1;" + std::string(20 * 1024, 'a'), "400");
+	check("trailer line too long", chunked + "3\r\nabc\r\n0\r\nX-Trailer: "
+		+ std::string(20 * 1024, 'a'), "431");
+
+	// 5. 1.5 MB en chunks de 64 KB vers /upload (max_size 1M)
+	std::string upload = chunked;
+	for (int i = 0; i < 24; i++)
+		upload += "10000\r\n" + std::string(0x10000, 'u') + "\r\n";
+	check("chunked upload past max_size", upload + "0\r\n\r\n", "413");
+	if (system("ls -a www/upload | grep -q error_close") == 0)
+	{
+		std::cout << "FAIL chunked upload past max_size: upload file left" << std::endl;
+		g_failures++;
+	}
+
+	kill(pid, SIGINT);
+	waitpid(pid, NULL, 0);
+
+	if (g_failures)
+	{
+		std::cout << g_failures << " FAILED" << std::endl;
+		return (1);
+	}
+	std::cout << "OK: all error close tests passed" << std::endl;
+	return (0);
+}
@@ -0,0 +1,35 @@
+#include <iostream>
+#include "http/RequestParser.hpp"
+
+/*
+	This test verifies the Expect header.
+	Expected:
+		100-continue          -> paused before the body, expectContinue=1
+		100-Continue (case)   -> expectContinue=1
+		HTTP/1.0 100-continue -> ignored, expectContinue=0
+		other expectation     -> hasError=1 and errorStatus=417
+*/
+
+static void	run(const std::string &raw)
+{
+	HttpRequestParser	parser;
+
+	parser.waitForBodySink(true);
+	parser.feed(raw);
+
+	std::cout << "needsBodySink=" << parser.needsBodySink()
+			  << " expectContinue=" << parser.getRequest().expectContinue
+			  << " error=" << parser.hasError();
+	if (parser.hasError())
+		std::cout << " status=" << parser.getErrorStatus();
+	std::cout << std::endl;
+}
+
+int	main()
+{
+	run("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\nExpect: 100-continue\r\n\r\n");
+	run("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\nExpect: 100-Continue\r\n\r\n");
+	run("POST /up HTTP/1.0\r\nContent-Length: 5\r\nExpect: 100-continue\r\n\r\n");
+	run("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\nExpect: something\r\n\r\n");
+	return (0);
+}
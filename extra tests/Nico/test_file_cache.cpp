@@ -0,0 +1,180 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+#include <sys/time.h>
+#include "router/FileCache.hpp"
+
+/*
+	Test program: FileCache (file_cache directive)
+
+	1. miss, insert, then hit with the same bytes, Content-Type and ETag;
+	   the serialized response outlives its entry (SharedBuffer)
+	2. file rewritten (size/mtime change) -> miss, entry dropped
+	3. file bigger than max_entry -> not cached
+	4. LRU: inserting past max_bytes evicts the least recently used entry;
+	   a file modified during the current second is not cached, weak ETag
+	5. max_bytes = 0 -> disabled
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_file_cache.cpp" src/router/FileCache.cpp \
+			src/http/Mime8.cpp src/http/ResponseBuilder7.cpp src/http/HttpResponse.cpp \
+			src/network/Clock.cpp -o test_file_cache
+*/
+
+static int	g_failures = 0;
+
+static void	check(const std::string &what, bool ok)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+// Written "a while ago": files modified during the current second are not cached
+static void	writeFile(const std::string &path, const std::string &content)
+{
+	static time_t	age = 100;
+	struct timeval	times[2];
+
+	{
+		std::ofstream	ofs(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		ofs << content;
+	}
+	times[0].tv_sec = time(NULL) - age--;	// each write gets its own mtime
+	times[0].tv_usec = 0;
+	times[1] = times[0];
+	utimes(path.c_str(), times);
+}
+
+// stat() + insert(), as Router::openFileBody()
+static const FileCache::Entry	*load(FileCache &cache, const std::string &path)
+{
+	struct stat	st;
+	int			fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return (NULL);
+	fstat(fd, &st);
+	const FileCache::Entry	*e = cache.insert(path, fd, st);
+	close(fd);
+	return (e);
+}
+
+// stat() + lookup(), as Router::fromFileCache()
+static const FileCache::Entry	*find(FileCache &cache, const std::string &path)
+{
+	struct stat	st;
+
+	if (stat(path.c_str(), &st) != 0)
+		return (NULL);
+	return (cache.lookup(path, st));
+}
+
+int	main()
+{
+	const std::string	a = "/tmp/fc_test_a.css";
+	const std::string	b = "/tmp/fc_test_b.html";
+	const std::string	c = "/tmp/fc_test_c.txt";
+
+	writeFile(a, std::string(400, 'a'));
+	writeFile(b, std::string(400, 'b'));
+	writeFile(c, std::string(400, 'c'));
+
+	// 1: miss, then hit
+	{
+		FileCache	cache(64 * 1024, 1024);
+
+		check("first lookup misses", find(cache, a) == NULL);
+		check("insert", load(cache, a) != NULL);
+		const FileCache::Entry	*e = find(cache, a);
+		check("hit", e != NULL && e->response.size() == e->bodyOffset + 400
+			&& std::string(e->response.data() + e->bodyOffset, 400) == std::string(400, 'a'));
+		check("prebuilt headers", e != NULL
+			&& std::string(e->response.data(), e->bodyOffset).find("Content-Length: 400\r\n") != std::string::npos
+			&& std::string(e->response.data(), e->bodyOffset).find("Content-Type: text/css\r\n") != std::string::npos);
+		check("content type", e != NULL && e->contentType == "text/css");
+		check("etag", e != NULL && e->etag.size() > 2 && e->etag[0] == '"');
+		check("counters", cache.getStats().hits == 1 && cache.getStats().misses == 1);
+	}
+
+	// 1b: an evicted entry stays readable for the responses still sending it
+	{
+		FileCache		cache(64 * 1024, 1024);
+		SharedBuffer	inFlight = load(cache, a)->response;
+
+		writeFile(a, std::string(400, 'z'));
+		find(cache, a);		// changed: entry dropped
+		check("in-flight response kept", cache.size() == 0 && inFlight.size() > 400
+			&& inFlight.data()[inFlight.size() - 1] == 'a');
+		writeFile(a, std::string(400, 'a'));
+	}
+
+	// 2: file changed on disk
+	{
+		FileCache	cache(64 * 1024, 1024);
+
+		load(cache, a);
+		writeFile(a, std::string(401, 'A'));
+		check("changed file misses", find(cache, a) == NULL);
+		check("stale entry dropped", cache.size() == 0 && cache.bytes() == 0);
+	}
+
+	// 3: max entry size
+	{
+		FileCache	cache(64 * 1024, 100);
+
+		check("too big: not cached", load(cache, b) == NULL && cache.size() == 0);
+	}
+
+	// 4: LRU eviction (room for two entries)
+	{
+		FileCache	cache(1300, 1000);
+
+		load(cache, a);
+		load(cache, b);
+		find(cache, a);		// b is now the least recently used
+		load(cache, c);
+		check("LRU entry evicted", find(cache, b) == NULL);
+		check("recent entries kept", find(cache, a) != NULL && find(cache, c) != NULL);
+		check("budget kept", cache.bytes() <= 1300 && cache.getStats().evictions == 1);
+	}
+
+	// 4b: modified during the current second: not cached yet, weak ETag
+	{
+		FileCache	cache(64 * 1024, 1024);
+		struct stat	st;
+
+		{
+			std::ofstream	ofs(c.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			ofs << "fresh";
+		}
+		stat(c.c_str(), &st);
+		check("fresh file not cached", load(cache, c) == NULL);
+		check("fresh file weak etag", FileCache::makeETag(st).compare(0, 3, "W/\"") == 0);
+		writeFile(c, "fresh");
+		stat(c.c_str(), &st);
+		check("older file strong etag", FileCache::makeETag(st)[0] == '"');
+		check("last modified", FileCache::makeLastModified(st).size() == 29);
+	}
+
+	// 5: disabled
+	{
+		FileCache	cache(0, 1024);
+
+		check("disabled", !cache.enabled() && load(cache, a) == NULL);
+	}
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+	std::remove(c.c_str());
+
+	if (g_failures == 0)
+		std::cout << "OK: all file cache tests passed" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include "http/NumberParse.hpp"
+#include "http/RequestParser.hpp"
+
+/*
+	Fuzz / property test: NumberParse against the previous behaviour
+
+	The parser used std::istringstream for Content-Length (decimal) and
+	chunk sizes (std::hex). For random inputs we check:
+
+	1. strictly valid input (only digits / only hex digits):
+	   - istringstream reads it  -> NumberParse gives NUM_OK, same value
+	   - istringstream fails     -> it was too big: NUM_OVERFLOW
+	2. anything else (sign, "0x", spaces, garbage, empty) -> NUM_INVALID,
+	   even where istringstream used to accept a prefix ("5abc", "-1")
+	3. boundaries: SIZE_MAX is accepted, SIZE_MAX + 1 overflows
+	4. end to end: the parser answers 400 on garbage, 413 on overflow
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_number_fuzz.cpp" src/http/NumberParse.cpp \
+			src/http/ByteScan.cpp src/http/HeaderTable.cpp src/http/BodySink.cpp src/http/RequestParser*.cpp \
+			src/network/RecvBuffer.cpp src/utils.cpp -o test_number_fuzz
+*/
+
+static int	g_failures = 0;
+
+static void	fail(const std::string &what, const std::string &input)
+{
+	if (g_failures < 20)
+		std::cout << "FAIL " << what << ": [" << input << "]" << std::endl;
+	g_failures++;
+}
+
+static bool	onlyChars(const std::string &s, const char *set)
+{
+	if (s.empty())
+		return (false);
+	return (s.find_first_not_of(set) == std::string::npos);
+}
+
+// Previous behaviour: istringstream >> size_t, rejecting leftovers
+static bool	oldDecimal(const std::string &s, size_t &out)
+{
+	std::istringstream	iss(s);
+	char				extra;
+
+	out = 0;
+	if (!(iss >> out))
+		return (false);
+	if (iss >> extra)
+		return (false);
+	return (true);
+}
+
+static bool	oldHex(const std::string &s, size_t &out)
+{
+	std::istringstream	iss(s);
+
+	out = 0;
+	iss >> std::hex >> out;
+	return (!iss.fail());
+}
+
+static void	checkDecimal(const std::string &s)
+{
+	size_t				ref;
+	size_t				got;
+	bool				refOk = oldDecimal(s, ref);
+	NumberParse::Result	res = NumberParse::decimal(s.data(), s.size(), got);
+
+	if (onlyChars(s, "0123456789"))
+	{
+		if (refOk && (res != NumberParse::NUM_OK || got != ref))
+			fail("decimal value", s);
+		if (!refOk && res != NumberParse::NUM_OVERFLOW)
+			fail("decimal overflow", s);
+	}
+	else if (res != NumberParse::NUM_INVALID)
+		fail("decimal invalid", s);
+}
+
+static void	checkHex(const std::string &s)
+{
+	size_t				ref;
+	size_t				got;
+	bool				refOk = oldHex(s, ref);
+	NumberParse::Result	res = NumberParse::hex(s.data(), s.size(), got);
+
+	if (onlyChars(s, "0123456789abcdefABCDEF"))
+	{
+		if (refOk && (res != NumberParse::NUM_OK || got != ref))
+			fail("hex value", s);
+		if (!refOk && res != NumberParse::NUM_OVERFLOW)
+			fail("hex overflow", s);
+	}
+	else if (res != NumberParse::NUM_INVALID)
+		fail("hex invalid", s);
+}
+
+static std::string	randomString(const char *alphabet, size_t maxLen)
+{
+	std::string	s;
+	size_t		n = std::rand() % (maxLen + 1);
+	size_t		a = std::string(alphabet).size();
+
+	for (size_t i = 0; i < n; i++)
+		s += alphabet[std::rand() % a];
+	return (s);
+}
+
+static int	parseStatus(const std::string &request)
+{
+	HttpRequestParser	parser;
+
+	parser.feed(request);
+	if (parser.hasError())
+		return (parser.getErrorStatus());
+	return (parser.isDone() ? 200 : 0);
+}
+
+int	main()
+{
+	std::srand(42);
+
+	// 1 + 2: random inputs, mostly digits, sometimes junk
+	for (int i = 0; i < 200000; i++)
+	{
+		checkDecimal(randomString("0123456789", 25));
+		checkDecimal(randomString("0123456789 +-xa\t", 8));
+		checkHex(randomString("0123456789abcdefABCDEF", 20));
+		checkHex(randomString("0123456789abcdefxX +-g;", 8));
+	}
+
+	// 3: boundaries (64-bit size_t)
+	std::ostringstream	max;
+	max << static_cast<size_t>(-1);
+	checkDecimal(max.str());
+	size_t	v;
+	if (NumberParse::decimal(max.str().data(), max.str().size(), v) != NumberParse::NUM_OK)
+		fail("SIZE_MAX decimal", max.str());
+	if (sizeof(size_t) == 8)
+	{
+		std::string over = "18446744073709551616";
+		if (NumberParse::decimal(over.data(), over.size(), v) != NumberParse::NUM_OVERFLOW)
+			fail("SIZE_MAX + 1 decimal", over);
+		if (NumberParse::hex("ffffffffffffffff", 16, v) != NumberParse::NUM_OK)
+			fail("SIZE_MAX hex", "ffffffffffffffff");
+		if (NumberParse::hex("10000000000000000", 17, v) != NumberParse::NUM_OVERFLOW)
+			fail("SIZE_MAX + 1 hex", "10000000000000000");
+	}
+
+	// 4: end to end through the parser
+	const std::string	post = "POST / HTTP/1.1\r\nHost: a\r\n";
+	if (parseStatus(post + "Content-Length: 5abc\r\n\r\n") != 400)
+		fail("parser Content-Length garbage -> 400", "5abc");
+	if (parseStatus(post + "Content-Length: -1\r\n\r\n") != 400)
+		fail("parser Content-Length negative -> 400", "-1");
+	if (parseStatus(post + "Content-Length: 99999999999999999999999\r\n\r\n") != 413)
+		fail("parser Content-Length overflow -> 413", "99999999999999999999999");
+	if (parseStatus(post + "Content-Length: 3\r\n\r\nabc") != 200)
+		fail("parser Content-Length ok", "3");
+	const std::string	chunked = post + "Transfer-Encoding: chunked\r\n\r\n";
+	if (parseStatus(chunked + "4;ext=1\r\nWiki\r\n0\r\n\r\n") != 200)
+		fail("parser chunk extension ok", "4;ext=1");
+	if (parseStatus(chunked + "0x4\r\nWiki\r\n0\r\n\r\n") != 400)
+		fail("parser chunk 0x prefix -> 400", "0x4");
+	if (parseStatus(chunked + "4zz\r\nWiki\r\n0\r\n\r\n") != 400)
+		fail("parser chunk garbage -> 400", "4zz");
+	if (parseStatus(chunked + "fffffffffffffffff\r\n") != 413)
+		fail("parser chunk overflow -> 413", "fffffffffffffffff");
+
+	if (g_failures == 0)
+		std::cout << "OK: NumberParse matches the previous parsing on valid input" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
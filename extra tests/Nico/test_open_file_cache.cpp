@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "router/OpenFileCache.hpp"
+#include "network/Clock.hpp"
+
+/*
+	Test program: OpenFileCache (open_file_cache directive)
+
+	1. stat() twice -> one miss, one hit; failed stat() cached too
+	2. open() hands out a readable duplicate, the cached fd survives its close()
+	3. file rewritten -> inotify event, sync() drops the entry
+	4. invalidate() (own writes: upload, DELETE)
+	5. LRU: at most max_entries entries
+	6. max_entries = 0 -> disabled, install() ignores it
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_open_file_cache.cpp" \
+			src/router/OpenFileCache.cpp src/network/Clock.cpp -o test_open_file_cache
+*/
+
+static int	g_failures = 0;
+
+static void	check(const std::string &what, bool ok)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+static void	writeFile(const std::string &path, const std::string &content)
+{
+	std::ofstream	ofs(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	ofs << content;
+}
+
+int	main()
+{
+	const std::string	a = "/tmp/ofc_test_a.txt";
+	const std::string	b = "/tmp/ofc_test_b.txt";
+	const std::string	c = "/tmp/ofc_test_c.txt";
+	const std::string	missing = "/tmp/ofc_test_missing.txt";
+	struct stat			st;
+
+	writeFile(a, "hello");
+	writeFile(b, "b");
+	writeFile(c, "c");
+	std::remove(missing.c_str());
+	Clock::update();
+
+	// 1: stat() cached, 404s too
+	{
+		OpenFileCache	cache(16, 60);
+
+		check("stat", cache.stat(a, st) && st.st_size == 5);
+		check("second stat is a hit", cache.stat(a, st) && cache.getStats().hits == 1);
+		check("missing file", !cache.stat(missing, st) && !cache.stat(missing, st));
+		check("missing file cached", cache.getStats().hits == 2 && cache.getStats().misses == 2);
+		check("access", cache.access(a, R_OK) && cache.stat(a, st));
+	}
+
+	// 2: open() returns a duplicate
+	{
+		OpenFileCache	cache(16, 60);
+		char			buf[16];
+
+		int	fd = cache.open(a, st);
+		check("open", fd >= 0 && st.st_size == 5);
+		check("read", fd >= 0 && pread(fd, buf, sizeof(buf), 0) == 5);
+		close(fd);
+		fd = cache.open(a, st);
+		check("reopen after close", fd >= 0 && pread(fd, buf, sizeof(buf), 0) == 5);
+		close(fd);
+		check("directory not opened", cache.open("/tmp", st) == -1);
+	}
+
+	// 3: inotify
+	{
+		OpenFileCache	cache(16, 60);
+
+		cache.stat(a, st);
+		writeFile(a, "hello world");
+		cache.sync();
+		check("modified file dropped", cache.size() == 0);
+		check("new size seen", cache.stat(a, st) && st.st_size == 11);
+	}
+
+	// 4: invalidate()
+	{
+		OpenFileCache	cache(16, 60);
+
+		cache.stat(missing, st);
+		writeFile(missing, "x");
+		cache.invalidate(missing);
+		check("invalidated entry reloaded", cache.stat(missing, st) && st.st_size == 1);
+		std::remove(missing.c_str());
+	}
+
+	// 5: LRU
+	{
+		OpenFileCache	cache(2, 60);
+
+		cache.stat(a, st);
+		cache.stat(b, st);
+		cache.stat(a, st);		// b is now the least recently used
+		cache.stat(c, st);
+		check("max entries kept", cache.size() == 2 && cache.getStats().evictions == 1);
+		cache.stat(a, st);
+		check("recent entry kept", cache.getStats().hits == 2);
+	}
+
+	// 6: disabled
+	{
+		OpenFileCache	cache(0, 60);
+
+		OpenFileCache::install(&cache);
+		check("disabled", !cache.enabled() && OpenFileCache::current() == NULL);
+	}
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+	std::remove(c.c_str());
+
+	if (g_failures == 0)
+		std::cout << "OK: all open file cache tests passed" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
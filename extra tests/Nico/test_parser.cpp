@@ -20,6 +20,6 @@ int main() {
 		std::cout << "Method: " << req.method << "\n";
 		std::cout << "Target: " << req.rawTarget << "\n";
 		std::cout << "Version: " << req.httpVersion << "\n";
-		std::cout << "Host header: " << req.headers.find("host")->second << "\n";
+		std::cout << "Host header: " << req.headers.get(HeaderTable::H_HOST).str() << "\n";
 	}
 }
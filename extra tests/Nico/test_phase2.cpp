@@ -7,7 +7,7 @@ int main() {
 	HttpRequest req;
 	req.method = METHOD_GET;
 	req.rawTarget = "/index.html";
-	req.headers["Host"] = "localhost";
+	req.headers.add("Host", 4, "localhost", 9);
 
 	HttpResponse resp(200, reasonPhrase(200));
 	resp.headers["Content-Type"] = "text/plain";
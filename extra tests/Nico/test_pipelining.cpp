@@ -17,9 +17,9 @@ static void	print_request(const HttpRequest &req)
 	std::cout << "	method (enum) = " << req.method << std::endl;
 	std::cout << "	target = " << req.rawTarget << std::endl;
 	std::cout << "	version = " << req.httpVersion << std::endl;
-	if (req.headers.find("host") != req.headers.end())
+	if (req.headers.has(HeaderTable::H_HOST))
 	{
-		std::cout << "	host = " << req.headers.find("host")->second << std::endl;
+		std::cout << "	host = " << req.headers.get(HeaderTable::H_HOST).str() << std::endl;
 	}
 }
 
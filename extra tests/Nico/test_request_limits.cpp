@@ -0,0 +1,162 @@
+#include <iostream>
+#include <string>
+#include "http/RequestParser.hpp"
+
+/*
+	Test program: request head limits
+
+	Limits are per request, not per connection, and checked while the
+	lines arrive (defaults: large_client_header_buffers 4 8k, max_headers 100).
+
+	1. 2000 keep-alive requests (~20 KB of headers each, 40 MB in total) on
+	   the same parser: none of them is rejected
+	2. one head bigger than the max total -> 431, whether it arrives
+	   complete or its last line never ends (not buffered forever)
+	3. start line longer than the max line -> 400, even without its CRLF
+	4. header line longer than the max line -> 431, even without its CRLF
+	5. more header lines than max_headers -> 431
+	6. setHeaderLimits(): limits of the server block
+	7. chunked bodies: an endless chunk size line -> 400, trailer fields
+	   accepted but capped like header lines (431)
+
+	Build (from the repo root):
+		c++ -std=c++98 -Iinclude "extra tests/Nico/test_request_limits.cpp" src/http/ByteScan.cpp src/http/HeaderTable.cpp \
+			src/http/NumberParse.cpp src/http/BodySink.cpp src/http/RequestParser*.cpp \
+			src/network/RecvBuffer.cpp src/utils.cpp -o test_request_limits
+*/
+
+static int	g_failures = 0;
+
+static void	check(const std::string &what, bool ok)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+		g_failures++;
+}
+
+static bool	status(const HttpRequestParser &parser, int code)
+{
+	return (parser.hasError() && parser.getErrorStatus() == code);
+}
+
+int	main()
+{
+	std::string	value(7000, 'c');	// one header line just under the max line
+	std::string	cookies = "Cookie: " + value + "\r\nX-A: " + value + "\r\nX-B: " + value + "\r\n";
+
+	// 1: the header budget starts again at each request
+	{
+		HttpRequestParser	parser;
+		std::string			raw = "GET / HTTP/1.1\r\nHost: a\r\n" + cookies + "\r\n";
+		int					served = 0;
+
+		for (int i = 0; i < 2000; i++)
+		{
+			parser.feed(raw);
+			if (!parser.isDone() || parser.hasError())
+				break ;
+			served++;
+			parser.resetKeepBuffer();
+		}
+		check("2000 keep-alive requests, 40 MB of headers", served == 2000);
+	}
+
+	// 2: one head too big, last line unfinished
+	{
+		HttpRequestParser	parser;
+
+		parser.feed("GET / HTTP/1.1\r\nHost: a\r\n" + cookies + "X-C: " + value + "\r\n");
+		check("under the limit: waiting", !parser.isDone() && !parser.hasError());
+		parser.feed("X-D: " + value);
+		check("431 past the max total", status(parser, 431));
+	}
+
+	// 2b: same head received in one read, complete
+	{
+		HttpRequestParser	parser;
+
+		parser.feed("GET / HTTP/1.1\r\nHost: a\r\n" + cookies + "X-C: " + value + "\r\nX-D: " + value + "\r\n\r\n");
+		check("431 on a complete head", status(parser, 431));
+	}
+
+	// 3: start line too long, with or without its end
+	{
+		HttpRequestParser	parser;
+		HttpRequestParser	parser2;
+
+		parser.feed("GET /" + std::string(HttpRequestParser::DEFAULT_MAX_LINE, 'a'));
+		check("400 on an endless start line", status(parser, 400));
+		parser2.feed("GET /" + std::string(HttpRequestParser::DEFAULT_MAX_LINE, 'a') + " HTTP/1.1\r\n");
+		check("400 on a long start line", status(parser2, 400));
+	}
+
+	// 4: header line too long, with or without its end
+	{
+		HttpRequestParser	parser;
+		HttpRequestParser	parser2;
+		std::string			big(HttpRequestParser::DEFAULT_MAX_LINE, 'x');
+
+		parser.feed("GET / HTTP/1.1\r\nHost: a\r\nX-Big: " + big);
+		check("431 on an endless header line", status(parser, 431));
+		parser2.feed("GET / HTTP/1.1\r\nHost: a\r\nX-Big: " + big + "\r\n\r\n");
+		check("431 on a long header line", status(parser2, 431));
+	}
+
+	// 5: header count
+	{
+		HttpRequestParser	parser;
+		HttpRequestParser	parser2;
+		std::string			lines;
+
+		for (size_t i = 1; i < HttpRequestParser::DEFAULT_MAX_HEADERS; i++)
+			lines += "X-H: v\r\n";
+		parser.feed("GET / HTTP/1.1\r\nHost: a\r\n" + lines + "\r\n");
+		check("max_headers lines accepted", parser.isDone() && !parser.hasError());
+		parser2.feed("GET / HTTP/1.1\r\nHost: a\r\n" + lines + "X-H: v\r\n");
+		check("431 past max_headers", status(parser2, 431));
+	}
+
+	// 6: server block limits
+	{
+		HttpRequestParser	parser;
+		HttpRequestParser	parser2;
+
+		parser.setHeaderLimits(64 * 1024, 128 * 1024, 10);
+		parser.feed("GET / HTTP/1.1\r\nHost: a\r\nX-Big: " + std::string(20000, 'x') + "\r\n\r\n");
+		check("bigger max line", parser.isDone() && !parser.hasError());
+		parser2.setHeaderLimits(64 * 1024, 128 * 1024, 2);
+		parser2.feed("GET / HTTP/1.1\r\nHost: a\r\nA: 1\r\nB: 2\r\n");
+		check("smaller max_headers", status(parser2, 431));
+	}
+
+	// 7: chunked body lines (size + extensions, trailers) have the same caps
+	{
+		const std::string	head = "POST / HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n";
+		HttpRequestParser	parser;
+		HttpRequestParser	parser2;
+		HttpRequestParser	parser3;
+		HttpRequestParser	parser4;
+
+		parser.feed(head + "1;");
+		for (int i = 0; i < 1000 && !parser.hasError(); i++)
+			parser.feed(std::string(10 * 1024, 'a'));	// 10 MB max, no CRLF
+		check("400 on an endless chunk size line", status(parser, 400));
+		parser2.feed(head + "4\r\nWiki\r\n0\r\nX-Trailer: 1\r\n");
+		parser2.feed("\r");
+		parser2.feed("\n");
+		check("trailer fields accepted, split final CRLF",
+			parser2.isDone() && !parser2.hasError() && parser2.getRequest().body == "Wiki");
+		parser3.feed(head + "0\r\nX-Trailer: " + std::string(HttpRequestParser::DEFAULT_MAX_LINE, 't'));
+		check("431 on an endless trailer line", status(parser3, 431));
+		parser4.feed(head + "0\r\n");
+		for (int i = 0; i < 1000 && !parser4.hasError(); i++)
+			parser4.feed("X-T: " + value + "\r\n");
+		check("431 past the trailer budget", status(parser4, 431));
+	}
+
+	if (g_failures == 0)
+		std::cout << "OK: all request limit tests passed" << std::endl;
+	else
+		std::cout << g_failures << " failure(s)" << std::endl;
+	return (g_failures != 0);
+}
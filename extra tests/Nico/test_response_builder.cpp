@@ -8,21 +8,47 @@
 
 int	main()
 {
-	HttpResponse	resp;
+	HttpResponse	resp(200, reasonPhrase(200));
 
-	resp.statusCode = 200;
-	resp.reason = reasonPhrase(200);
 	resp.headers["Content-Type"] = "text/plain";
 	resp.body = "Hello response builder";
 
 	std::string	raw;
 
-	raw = ResponseBuilder::build(resp, false);
+	// Written in place, as in Server (raw = the Connection's send_buffer)
+	ResponseBuilder::build(raw, resp, false);
 
 	std::cout << "RAW RESPONSE:" << std::endl;
 	std::cout << "------------------------" << std::endl;
 	std::cout << raw << std::endl;
 	std::cout << "------------------------" << std::endl;
 
+	// Custom reason: status line built by hand
+	HttpResponse	custom(599, "Custom Reason");
+	std::cout << ResponseBuilder::build(custom, true).substr(0, 28) << std::endl;
+
+	// File body (sendfile): headers only, Content-Length of the file
+	HttpResponse	file(200, reasonPhrase(200));
+	file.bodyFd = 0;
+	file.bodyLength = 200000000;
+	std::string	head = ResponseBuilder::build(file, false);
+	std::cout << "file body: "
+			  << (head.find("Content-Length: 200000000\r\n") != std::string::npos ? "ok" : "FAIL")
+			  << ", ends with headers: "
+			  << (head.compare(head.size() - 4, 4, "\r\n\r\n") == 0 ? "ok" : "FAIL") << std::endl;
+
+	// Prebuilt (file cache): status line, Connection and Date only
+	HttpResponse	cached(200, reasonPhrase(200));
+	std::string		tail;
+	ResponseBuilder::buildPrebuilt(tail, resp);
+	cached.prebuilt = SharedBuffer::adopt(tail);
+	head = ResponseBuilder::build(cached, false);
+	std::cout << "prebuilt: "
+			  << (head.find("Server:") == std::string::npos
+				  && head.compare(head.size() - 5, 5, "GMT\r\n") == 0 ? "ok" : "FAIL")
+			  << ", same bytes: "
+			  << (head + std::string(cached.prebuilt.data(), cached.prebuilt.size())
+				  == ResponseBuilder::build(resp, false) ? "ok" : "FAIL") << std::endl;
+
 	return (0);
 }
@@ -45,8 +45,8 @@ int	main()
 			Headers are stored lowercased in the parser:
 			"Host" becomes "host"
 		*/
-		std::cout << "	host = " << req.headers.find("host")->second << std::endl;
-		std::cout << "	user-agent = " << req.headers.find("user-agent")->second << std::endl;
+		std::cout << "	host = " << req.headers.get(HeaderTable::H_HOST).str() << std::endl;
+		std::cout << "	user-agent = " << req.headers.find("user-agent").str() << std::endl;
 	}
 	else if (parser.hasError())
 	{
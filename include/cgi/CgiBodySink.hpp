@@ -0,0 +1,30 @@
+#ifndef CGIBODYSINK_HPP
+#define CGIBODYSINK_HPP
+
+#include "../http/BodySink.hpp"
+
+struct CgiProcess;
+
+/**
+ * @brief Request body streamed to the stdin of a running CGI
+ *
+ * The CGI is started as soon as the headers are parsed. Bytes received
+ * from the client are queued in CgiProcess::body and the Server writes
+ * them to pipe_in on POLLOUT (handleCgiWrite). The queue only holds what
+ * the script has not read yet: the Server stops reading the client while
+ * it is above its backlog limit.
+ */
+class CgiBodySink : public BodySink {
+public:
+	CgiBodySink();
+
+	void attach(CgiProcess* cgi);
+
+	bool write(const char* data, size_t len);
+	bool finish(HttpRequest& req);
+
+private:
+	CgiProcess* _cgi;
+};
+
+#endif
@@ -33,18 +33,23 @@ public:
 	 * - Handle POLLIN on pipe_out to read output
 	 * - Call waitpid() with WNOHANG periodically
 	 *
-	 * @param req The HTTP request
+	 * @param req The HTTP request (headers only if its Content-Length body
+	 *            is still arriving: it is then streamed via cgi->stdin_sink)
 	 * @param scriptPath Full path to the CGI script
 	 * @param client_fd The client socket waiting for response
 	 * @param interpreterPath Path to interpreter (empty for auto-detect)
 	 * @param timeout Maximum execution time in seconds
+	 * @param into CgiProcess to fill (in its default state, e.g. from an
+	 *             ObjectPool), NULL to allocate a new one. Still owned by the
+	 *             caller if NULL is returned
 	 * @return CgiProcess* Process info, or NULL on immediate failure
 	 */
 	static CgiProcess* startCgi(const HttpRequest& req,
 								const std::string& scriptPath,
 								int client_fd,
 								const std::string& interpreterPath = "",
-								int timeout = 10);
+								int timeout = 10,
+								CgiProcess* into = NULL);
 
 	// NOTE: execute() was removed - violated "non-blocking at all times" requirement
 
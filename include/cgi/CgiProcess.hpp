@@ -4,6 +4,9 @@
 #include <string>
 #include <ctime>
 #include <sys/types.h>
+#include "../network/TimerWheel.hpp"
+#include "../network/ObjectPool.hpp"
+#include "CgiBodySink.hpp"
 
 /**
  * @brief Represents an active CGI process for non-blocking execution
@@ -24,13 +27,18 @@ struct CgiProcess {
 	int pipe_out;           // Read end of stdout pipe (to read CGI output)
 	int client_fd;          // Client socket waiting for this CGI response
 
-	std::string body;       // Request body to send to CGI (POST data)
+	std::string body;       // Request body to send to CGI (POST data), queued by stdin_sink when streamed
 	size_t body_written;    // Bytes already written to CGI stdin
+	bool body_complete;     // No more body bytes will be queued (close stdin once written)
+	bool stdin_armed;       // pipe_in registered for POLLOUT (only while bytes are queued)
+	CgiBodySink stdin_sink; // Parser sink of a body streamed while the CGI runs
 
 	std::string output;     // Accumulated CGI output
 
 	time_t start_time;      // When CGI started (for timeout)
 	int timeout;            // Timeout in seconds
+	TimerNode timer;        // Armed by Server in its TimerWheel
+	bool timed_out;         // Set when the timer fired (504)
 
 	State state;            // Current state
 	bool should_close;      // Close connection after response (HTTP/1.0 compat)
@@ -42,19 +50,46 @@ struct CgiProcess {
 		, client_fd(-1)
 		, body()
 		, body_written(0)
+		, body_complete(true)
+		, stdin_armed(false)
+		, stdin_sink()
 		, output()
 		, start_time(0)
 		, timeout(30)
+		, timer()
+		, timed_out(false)
 		, state(CGI_WRITING_BODY)
 		, should_close(false)
-	{}
+	{
+		stdin_sink.attach(this);
+	}
 
 	bool hasBodyToWrite() const {
 		return body_written < body.size();
 	}
 
 	bool isTimedOut() const {
-		return (time(NULL) - start_time) > timeout;
+		return timed_out;
+	}
+
+	// Back to the Server's ObjectPool: default state, buffers kept under
+	// capacity_cap (pipes/process must already be released by cleanupCgi)
+	void recycle(size_t capacity_cap) {
+		pid = -1;
+		pipe_in = -1;
+		pipe_out = -1;
+		client_fd = -1;
+		recycleBuffer(body, capacity_cap);
+		body_written = 0;
+		body_complete = true;
+		stdin_armed = false;
+		recycleBuffer(output, capacity_cap);
+		start_time = 0;
+		timeout = 30;
+		timer = TimerNode();
+		timed_out = false;
+		state = CGI_WRITING_BODY;
+		should_close = false;
 	}
 };
 
@@ -10,9 +10,34 @@
 #include "Tokeniser.hpp"
 #include "colours.hpp"
 
+/**
+ * @brief Event backend used by IOMultiplexer, selected by the top-level
+ * `event_backend` directive
+ */
+typedef enum e_event_backend {
+	BACKEND_POLL,//		0
+	BACKEND_EPOLL,//	1
+	BACKEND_IO_URING//	2
+}	EventBackend;
+
+
 /**
  * @brief The main object that contains all ServerBlocks, which in turn
- * contain all LocationBlocks within them
+ * contain all LocationBlocks within them. Also stores the top-level
+ * (global) directives that are not tied to a specific server block
+ * @param eventBackend `event_backend poll|epoll|io_uring;` defaults to poll
+ * @param edgeTriggered `edge_triggered on|off;` only honoured by epoll
+ * @param workerThreads `worker_threads N|auto;` number of reactors, defaults to 1
+ * @param workerProcesses `worker_processes N|auto;` pre-forked workers under a
+ * master process, defaults to 0 (no master)
+ * @param acceptBatch `accept_batch N;` max connections accepted per readiness
+ * event on a listening socket, defaults to 64
+ * @param fileCacheSize `file_cache size [max_entry];` bytes of static files
+ * kept in memory per reactor, defaults to 0 (off)
+ * @param fileCacheMaxEntry bigger files are not cached (sendfile())
+ * @param openFileCacheMax `open_file_cache max=N [valid=S];` stat()/open()
+ * results kept per reactor, defaults to 0 (off)
+ * @param openFileCacheValid seconds before a cached stat() is redone
  */
 class Config {
 	public:
@@ -26,6 +51,17 @@ class Config {
 
 // 		vector of all ServerBlocks defined in config file
 		std::vector<ServerBlock>	servers;
+
+// 		global directives (outside of any server block)
+		EventBackend				eventBackend;
+		bool						edgeTriggered;
+		int							workerThreads;
+		int							workerProcesses;
+		int							acceptBatch;
+		size_t						fileCacheSize;
+		size_t						fileCacheMaxEntry;
+		size_t						openFileCacheMax;
+		unsigned					openFileCacheValid;
 };
 
 #endif
\ No newline at end of file
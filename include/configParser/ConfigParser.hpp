@@ -28,6 +28,13 @@ typedef void	(ConfigParser::*ServerFn)(ServerBlock& s);
  */
 typedef void	(ConfigParser::*LocationFn)(LocationBlock& l);
 
+/**
+ * @brief Typedef for function pointers to any function in the
+ * `ConfigParser` namespace that takes the following parameter:
+ * @param Config
+ */
+typedef void	(ConfigParser::*GlobalFn)(Config& c);
+
 
 
 /**
@@ -47,6 +54,7 @@ class ConfigParser {
 		// maps that pair server/location directives with their respective parsing functions
 		std::map<std::string, ServerFn>		serverDirectives;
 		std::map<std::string, LocationFn>	locationDirectives;
+		std::map<std::string, GlobalFn>		globalDirectives;
 
 
 
@@ -80,6 +88,8 @@ class ConfigParser {
 		void		parseAutoIndex(ServerBlock& s);
 		void		parseMaxSize(ServerBlock& s);
 		void		parseUpload(ServerBlock& s);
+		void		parseLargeClientHeaderBuffers(ServerBlock& s);
+		void		parseMaxHeaders(ServerBlock& s);
 		void		getSizeAndUnit(const Token& sizeToken, long& num, std::string& unit);
 		void	parseCgiBin(LocationBlock& l);
 		void	parseCgiExtension(LocationBlock& l);
@@ -87,6 +97,23 @@ class ConfigParser {
 		void		updateUnit(std::string& unit, const std::string& currentToken);
 
 
+//---------------------------------------------------------------------------//
+//				GLOBAL (TOP-LEVEL) DIRECTIVE PARSING FUNCTIONS
+//---------------------------------------------------------------------------//
+
+		void		parseGlobalDirective(Config& c);
+		void		parseEventBackend(Config& c);
+		void		parseEdgeTriggered(Config& c);
+		void		parseWorkerThreads(Config& c);
+		void		parseWorkerProcesses(Config& c);
+		int			parseWorkerCount(const Token& valueToken);
+		void		parseAcceptBatch(Config& c);
+		void		parseFileCache(Config& c);
+		void		parseOpenFileCache(Config& c);
+		bool		parseOnOff(const Token& valueToken);
+		long		parseCount(const Token& valueToken, long min, long max);
+
+
 //---------------------------------------------------------------------------//
 //					LOCATION BLOCK PARSING FUNCTIONS
 //---------------------------------------------------------------------------//
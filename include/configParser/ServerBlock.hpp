@@ -19,10 +19,16 @@ class LocationBlock;
  * the given Location, then we fallback to the Server and check the Server's info
  * @param locations All LocationBlocks objects stored within this ServerBlock
  * @param port The port the server listens on.
+ * @param backlog listen() queue length, `listen 8080 backlog=N;` (default 128)
  * @param root Where to look in our file system (root + URI = path)
  * @param index default file to feed for GET requests
  * @param autoIndex Enables/disables directory listing if GET requested a directory
  * @param clientMaxBodySize The max size allowed for any client HTTP request
+ * @param headerLineMax `large_client_header_buffers N size;` max length of the
+ * request line or of one header line (default 8K)
+ * @param headerTotalMax N * size of `large_client_header_buffers`: max size of
+ * the request line + headers of one request (default 32K)
+ * @param maxHeaders `max_headers N;` max number of header lines (default 100)
  * @param errorPages map that contains pairs of int (HTTP status code) and a vector
  * of strings (all files to try and return with the given status code)
  */
@@ -35,6 +41,7 @@ class ServerBlock {
 		bool						hasRoot;
 
 		int							port;//		Validated at parsing (not checked for reserved ports)
+		int							backlog;
 		std::vector<std::string>	defaultMethods;
 		std::vector<LocationBlock>	locations;
 
@@ -43,6 +50,9 @@ class ServerBlock {
 		bool						autoIndex;
 		std::map<int, StringVec>	errorPages;
 		size_t						clientMaxBodySize; // defaults to 512Mb
+		size_t						headerLineMax;
+		size_t						headerTotalMax;
+		size_t						maxHeaders;
 
 		std::string					uploadDir;
 	};
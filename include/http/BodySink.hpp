@@ -0,0 +1,83 @@
+#ifndef BODYSINK_HPP
+#define BODYSINK_HPP
+
+#include <cstddef>
+#include <string>
+
+struct HttpRequest;
+
+/*
+	BodySink: where the parser sends the request body, as it arrives.
+
+	Before, the whole body was appended to HttpRequest::body, then copied
+	again into the upload file or into CgiProcess::body. Now the Server
+	picks a sink once the headers are parsed (Router::planBody()) and each
+	read only hands the new bytes over: a big upload costs a bounded amount
+	of memory instead of its own size.
+
+	- MemoryBodySink  : HttpRequest::body, as before (small bodies, tests)
+	- DiscardBodySink : body read then dropped (the response does not use it)
+	- FileBodySink    : upload file of a POST
+	- CgiBodySink     : stdin of a CGI started as soon as the headers are
+	                    parsed (see cgi/CgiBodySink.hpp)
+*/
+class BodySink
+{
+public:
+	virtual ~BodySink();
+
+	// false = the bytes could not be stored (the request fails with 500)
+	virtual bool	write(const char *data, size_t len) = 0;
+	// Whole body received: flush/close, record in req where the body went
+	virtual bool	finish(HttpRequest &req);
+	// Request dropped before the end of the body (error, client gone)
+	virtual void	abort();
+};
+
+class MemoryBodySink : public BodySink
+{
+public:
+	explicit MemoryBodySink(std::string &body);
+
+	bool	write(const char *data, size_t len);
+
+private:
+	std::string	&_body;
+};
+
+class DiscardBodySink : public BodySink
+{
+public:
+	bool	write(const char *data, size_t len);
+};
+
+/*
+	Upload file: a temporary file next to the target is created when the
+	sink is chosen and written with write() as the body arrives. finish()
+	renames it over the target and sets req.uploadPath so that
+	Router::handlePost() does not write the body a second time.
+	abort() removes the temporary file: the target is left as it was.
+*/
+class FileBodySink : public BodySink
+{
+public:
+	FileBodySink();
+	~FileBodySink();
+
+	bool	open(const std::string &path);
+	bool	write(const char *data, size_t len);
+	bool	finish(HttpRequest &req);
+	void	abort();
+
+private:
+	int			_fd;
+	std::string	_path;		// upload target
+	std::string	_tmpPath;	// body written here until finish(), empty = none
+
+	void	close();
+
+	FileBodySink(const FileBodySink &);
+	FileBodySink &operator=(const FileBodySink &);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef BYTESCAN_HPP
+#define BYTESCAN_HPP
+
+#include <cstddef>
+
+/*
+	ByteScan: finds the delimiters of one HTTP line in a single pass.
+
+	The parser used to look for "\r\n" with std::string::find(), then
+	split the line again with find(':') or std::istringstream. Here one
+	pass over the bytes records, for the current line:
+
+		"GET /index.html HTTP/1.1\r\n"      "Host: localhost\r\n"
+		    ^           ^           ^            ^              ^
+		  space1      space2      length       colon          length
+
+	The bytes are compared 32 (AVX2) or 16 (SSE2) at a time against
+	'\r', ':' and ' ' at once; only the matching positions are looked at.
+	Once ':' and two spaces are known, only '\r' is searched (memchr).
+	AVX2 is chosen at runtime (cpuid), SSE2 is always there on x86-64,
+	other CPUs use the scalar loop.
+*/
+class ByteScan
+{
+public:
+	static const size_t	npos = static_cast<size_t>(-1);
+
+	/*
+		Line: positions relative to the start of the line.
+		A scan can be resumed (line arriving in several reads): the fields
+		already found are kept, only npos fields are filled.
+	*/
+	struct Line
+	{
+		size_t	length;		// bytes before "\r\n" (npos = no complete line yet)
+		size_t	colon;		// first ':'
+		size_t	space1;		// first ' '
+		size_t	space2;		// second ' '
+
+		Line() : length(npos), colon(npos), space1(npos), space2(npos) {}
+	};
+
+	enum Impl
+	{
+		IMPL_SCALAR,
+		IMPL_SSE2,
+		IMPL_AVX2
+	};
+
+	/*
+		scanLine(p, len, from, line)
+		- Scans p[from .. len) (from = bytes already scanned by a previous
+		  call on the same line).
+		- Returns true and sets line.length if "\r\n" was found.
+	*/
+	static bool			scanLine(const char *p, size_t len, size_t from, Line &line);
+
+	// Best implementation for this CPU, or the one forced (benchmarks)
+	static Impl			implementation();
+	static void			forceImplementation(Impl impl);
+	static const char	*implementationName(Impl impl);
+
+private:
+	static Impl	_impl;			// chosen once, at static initialization (before any thread)
+
+	static Impl	detect();
+
+	static bool	scanScalar(const char *p, size_t len, size_t from, Line &line);
+	static bool	scanSse2(const char *p, size_t len, size_t from, Line &line);
+	static bool	scanAvx2(const char *p, size_t len, size_t from, Line &line);
+	static bool	scanCr(const char *p, size_t len, size_t from, Line &line);
+	static bool	visit(const char *p, size_t len, size_t pos, Line &line);
+	static bool	complete(const Line &line);
+};
+
+#endif
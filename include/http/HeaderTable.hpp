@@ -0,0 +1,103 @@
+#ifndef HEADERTABLE_HPP
+#define HEADERTABLE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+	HeaderView: read-only (pointer, length) view of a header name or value.
+	data == NULL means "header not present".
+
+	Views point into the HeaderTable arena: they stay valid until the next
+	add() or clear() on that table (read them once parsing is done).
+*/
+struct HeaderView
+{
+	const char	*data;
+	size_t		size;
+
+	HeaderView() : data(NULL), size(0) {}
+	HeaderView(const char *d, size_t n) : data(d), size(n) {}
+
+	bool		present() const { return (data != NULL); }
+	std::string	str() const;
+
+	// Case-insensitive comparisons, lower must be lowercase (no allocation)
+	bool		equals(const char *lower) const;
+	bool		containsNoCase(const char *lower) const;
+};
+
+/*
+	HeaderTable: request headers without one allocation per header.
+
+	Before, every header line cost substr() + trim() + toLower() + a
+	std::map node. Here:
+	- names (lowercased while copied) and values are appended to one
+	  arena, and a flat vector of (name, value) slices points into it
+	- both vectors keep their capacity across requests (parser pooled
+	  with its HttpRequest), so steady-state parsing does not allocate
+	- well-known headers get an enum-indexed slot, filled by add():
+	  get(H_HOST) is O(1), no string compare
+	- other headers: find("x-custom") is a linear scan (a request has
+	  a handful of headers, this beats a map)
+
+	The slices point into an arena rather than into the receive buffer:
+	the receive buffer is consumed, compacted and reused for the body
+	while the request is still in use.
+
+	Duplicate headers: the last one wins (same as the previous map).
+*/
+class HeaderTable
+{
+public:
+	enum Known
+	{
+		H_HOST,
+		H_CONTENT_LENGTH,
+		H_CONTENT_TYPE,
+		H_TRANSFER_ENCODING,
+		H_CONNECTION,
+		H_EXPECT,
+		H_IF_NONE_MATCH,
+		H_IF_MODIFIED_SINCE,
+		H_COUNT
+	};
+
+	HeaderTable();
+
+	// name is lowercased while copied, both must already be trimmed
+	void		add(const char *name, size_t nameLen, const char *value, size_t valueLen);
+	void		clear();
+	// clear() + release the arena if it grew beyond capacityCap
+	void		recycle(size_t capacityCap);
+
+	size_t		size() const;
+	bool		empty() const;
+	HeaderView	name(size_t i) const;
+	HeaderView	value(size_t i) const;
+	// true if a later header has the same name (it wins)
+	bool		overridden(size_t i) const;
+
+	bool		has(Known k) const;
+	HeaderView	get(Known k) const;
+	// lowerName must be lowercase; absent = HeaderView().present() == false
+	HeaderView	find(const char *lowerName) const;
+
+private:
+	struct Field
+	{
+		size_t	nameOff;
+		size_t	nameLen;
+		size_t	valueOff;
+		size_t	valueLen;
+	};
+
+	std::vector<char>	_arena;
+	std::vector<Field>	_fields;
+	int					_known[H_COUNT];	// index in _fields, -1 = absent
+
+	static int	knownIndex(const char *lowerName, size_t len);
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include <map>
 #include <sstream>
 #include <ctime>
+#include <sys/types.h>
+#include "network/SharedBuffer.hpp"
 
 typedef std::map<std::string, std::string> StringMap;
 
@@ -23,6 +25,18 @@ struct HttpResponse
 	bool				isCgiPending;
 	std::string			cgiScriptPath;
 
+	// File body (static GET): body stays empty, the Connection sends
+	// bodyLength bytes of bodyFd from bodyOffset with sendfile() and closes it
+	int					bodyFd;		// -1 = body in memory
+	off_t				bodyOffset;
+	size_t				bodyLength;
+
+	// Small static file from the file cache: everything after the Date
+	// header (Server, Content-Length, Content-Type, ETag, body), serialized
+	// once. build() writes only the status line, Connection and Date, the
+	// Connection sends these bytes after them (shared, not copied)
+	SharedBuffer		prebuilt;
+
 	// HttpResponse(int code = 200, const std::string &msg = "OK")
 	// 	: statusCode(code), reason(msg) {}
 	HttpResponse(int code, const std::string& msg);
@@ -31,7 +45,6 @@ struct HttpResponse
 	bool isSuccess() const { return statusCode >= 200 && statusCode < 300; }
 };
 
-std::string	buildDateValue();
 std::string	toStringSize(size_t n);
 
 #endif
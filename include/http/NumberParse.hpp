@@ -0,0 +1,34 @@
+#ifndef NUMBERPARSE_HPP
+#define NUMBERPARSE_HPP
+
+#include <cstddef>
+
+/*
+	NumberParse: strict, overflow-checked parsing of the numbers found in
+	request framing (Content-Length, chunk sizes).
+
+	Replaces the std::istringstream built for every request / every chunk
+	(locale-aware stream construction was one of the most expensive steps
+	of a small request) and is stricter than it:
+	- only digits: no sign, no "0x", no leading/trailing spaces, no garbage
+	  ("-1" used to wrap around to SIZE_MAX, "5abc" chunk sizes read as 5)
+	- a value that does not fit in size_t is reported as OVERFLOW, so the
+	  caller can answer 413 instead of 400
+*/
+class NumberParse
+{
+public:
+	enum Result
+	{
+		NUM_OK,
+		NUM_INVALID,	// empty or not only digits -> 400
+		NUM_OVERFLOW	// valid digits, value > SIZE_MAX -> 413
+	};
+
+	// 1*DIGIT
+	static Result	decimal(const char *p, size_t len, size_t &out);
+	// 1*HEXDIG (upper or lower case)
+	static Result	hex(const char *p, size_t len, size_t &out);
+};
+
+#endif
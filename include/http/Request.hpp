@@ -2,7 +2,7 @@
 #define REQUEST_HPP
 
 #include <string>
-#include <map>
+#include "HeaderTable.hpp"
 
 enum HttpMethod
 {
@@ -12,8 +12,6 @@ enum HttpMethod
 	METHOD_UNKNOWN
 };
 
-typedef std::map<std::string, std::string> HeaderMap;
-
 struct HttpRequest
 {
 	HttpMethod method;
@@ -24,30 +22,41 @@ struct HttpRequest
 
 	std::string httpVersion; // "HTTP/1.1"
 
-	std::map<std::string, std::string> headers;
+	HeaderTable headers;   // names lowercased, see HeaderTable::Known for O(1) lookups
 
 	// Body metadata
 	bool hasContentLength;
 	size_t contentLength;
 	bool chunked;
-	size_t bodyBytesRead;
+	size_t bodyBytesRead;  // body bytes received, whatever BodySink they went to
+
+	// "Expect: 100-continue": the client waits for "100 Continue" before the body
+	bool expectContinue;
 
 	/* Chunked decoding state (used only when chunked == true) */
-	size_t	chunkSize;			// current chunk size we are reading
+	size_t	chunkSize;			// bytes of the current chunk not read yet
 	bool	chunkSizeKnown;		// true after we parsed the chunk size line
+	bool	lastChunk;			// "0" chunk seen: trailer fields and final CRLF left
 
 
-	// Body buffer (optional for now)
+	// Body buffer (MemoryBodySink only: empty when the body was streamed elsewhere)
 	std::string body;
 
+	// Set by FileBodySink when the body was streamed to an upload file
+	std::string uploadPath;
+	bool uploadExisted;
+
 	HttpRequest()
 		: method(METHOD_UNKNOWN),
 		  hasContentLength(false),
 		  contentLength(0),
 		  chunked(false),
 		  bodyBytesRead(0),
+		  expectContinue(false),
 		  chunkSize(0),
-		  chunkSizeKnown(false)
+		  chunkSizeKnown(false),
+		  lastChunk(false),
+		  uploadExisted(false)
 
 	{}
 };
@@ -3,6 +3,10 @@
 
 #include <string>
 #include "Request.hpp"
+#include "../network/RecvBuffer.hpp"
+#include "ByteScan.hpp"
+#include "NumberParse.hpp"
+#include "BodySink.hpp"
 
 /*
 	ParserState = where we currently are while parsing one HTTP request.
@@ -20,7 +24,7 @@ enum ParserState
 {
 	PS_START_LINE,   // Parsing: "GET /path HTTP/1.1"
 	PS_HEADERS,      // Parsing: "Host: ...", "User-Agent: ...", until empty line
-	PS_BODY,         // (later) Parsing message body: Content-Length or chunked
+	PS_BODY,         // Parsing message body: Content-Length or chunked (sent to a BodySink)
 	PS_DONE,         // Finished parsing 1 full request
 	PS_ERROR         // Parsing failed, _errorStatus tells which HTTP error (e.g. 400)
 };
@@ -29,19 +33,40 @@ bool	sanitizeUrlPath(std::string& path);
 /*
 	HttpRequestParser turns raw bytes into a HttpRequest object.
 
-	- Module 1 (network) will read() from sockets and call feed(data).
-	- This parser will store bytes in _buffer until it has complete lines.
+	- Module 1 (network) binds the parser to the connection's RecvBuffer,
+	  recv()s into it and calls parse(): the bytes are parsed in place.
+	- feed(data) is the copying version (standalone use, tests).
+	- Bytes stay in the input buffer until they form complete lines.
 	- When parsing is complete, isDone() becomes true and you can call getRequest().
 */
 class HttpRequestParser
 {
 public:
+	/*
+		Limits of one request head (start line + headers + CRLFs), checked
+		while the lines arrive. Counted per request, from 0 again after
+		each request: a keep-alive connection can carry any number of
+		requests. Defaults = nginx "large_client_header_buffers 4 8k".
+		- max line   : start line -> 400, header line -> 431
+		- max total  : whole head -> 431
+		- max headers: number of header lines -> 431
+	*/
+	static const size_t	DEFAULT_MAX_LINE = 8 * 1024;
+	static const size_t	DEFAULT_MAX_HEADER_SIZE = 4 * DEFAULT_MAX_LINE;
+	static const size_t	DEFAULT_MAX_HEADERS = 100;
+
 	HttpRequestParser();
 
+	// Per server block (large_client_header_buffers, max_headers)
+	void	setHeaderLimits(size_t maxLine, size_t maxTotal, size_t maxHeaders);
+
 	// Reset the parser so we can parse a NEW request on the same connection
 	// (important for keep-alive where multiple requests share 1 socket).
 	void reset();
 
+	// ObjectPool: reset() + release the buffers grown beyond capacity_cap
+	void	recycle(size_t capacity_cap);
+
 	void	resetKeepBuffer();
 	bool	hasBufferedData() const;
 
@@ -50,11 +75,23 @@ public:
 	/*
 		feed(data)
 		- Add new raw bytes to the parser.
-		- The parser appends them to _buffer and tries to parse as much as possible.
+		- The parser appends them to its input buffer and tries to parse as much as possible.
 		- It does NOT block. It only uses what is available.
 	*/
 	void feed(const std::string &data);
 
+	/*
+		bind(input)
+		- Parse directly from input (the Connection's receive buffer)
+		  instead of the parser's own buffer. NULL = own buffer again.
+		- The parser consume()s what it parsed, leftovers (pipelined
+		  request) stay in input.
+	*/
+	void bind(RecvBuffer *input);
+
+	// Parse as much as possible of what is already in the input buffer.
+	void parse();
+
 	// True when we successfully parsed one complete request (start line + headers + body).
 	bool isDone() const;
 
@@ -68,10 +105,22 @@ public:
 	// Returns the parsed request.
 	const HttpRequest &getRequest() const;
 
-	// void	setMaxBodySize(size_t n) { _hasMaxBodySize = true; _maxBodySize = n; }
-	// void	clearMaxBodySize() { _hasMaxBodySize = false; _maxBodySize = 0; }
-	// bool	needsMaxBodySize() const {return (_state == PS_BODY && _hasMaxBodySize == false);}
-
+	/*
+		Body destination (the Server streams bodies instead of buffering them)
+		- waitForBodySink(true): once the headers are parsed, parse() stops
+		  and needsBodySink() becomes true, so the Server can route the
+		  request (headers only) and choose where the body goes.
+		- then ONE of the calls below resumes parsing. Body bytes are handed
+		  to the sink as they arrive; when the body reaches maxBodySize bytes
+		  the request fails with 413 (same rule as Router::exceedsMaxSize).
+		Without waitForBodySink() the body is kept in memory (feed(), tests).
+	*/
+	void	waitForBodySink(bool wait);
+	bool	needsBodySink() const;
+	void	keepBody(size_t maxBodySize);                 // getRequest().body
+	void	discardBody(size_t maxBodySize);              // read and dropped
+	bool	streamBodyToFile(const std::string &path, size_t maxBodySize);  // false = open failed
+	void	streamBodyTo(BodySink *sink, size_t maxBodySize);               // e.g. CGI stdin
 
 
 private:
@@ -80,11 +129,21 @@ private:
 
 	/*
 		Raw input buffer:
-		- We append new bytes here.
-		- We remove bytes from here as we successfully parse lines/body.
+		- _in points to the bound Connection buffer, or to _own (feed()).
+		- We consume bytes from it as we successfully parse lines/body.
 		- This allows incremental parsing when data arrives in pieces.
 	*/
-	std::string	_buffer;
+	RecvBuffer	_own;
+	RecvBuffer*	_in;
+
+	/*
+		Bytes at the start of the input already searched for "\r\n"
+		without success: when a long line arrives in many small reads,
+		nextLine() resumes the scan there instead of rescanning it all.
+		_line keeps the delimiters found so far in that partial line.
+	*/
+	size_t			_scanned;
+	ByteScan::Line	_line;
 
 	// The request we are building while parsing
 	HttpRequest	_req;
@@ -92,9 +151,24 @@ private:
 	// If state is PS_ERROR, this holds the HTTP error status code (e.g. 400)
 	int			_errorStatus;
 
+	// Current request head so far, and its limits (setHeaderLimits())
+	size_t		_headBytes;
+	size_t		_headerCount;
+	size_t		_maxLine;
+	size_t		_maxHeadSize;
+	size_t		_maxHeaders;
 
-	// bool		_hasMaxBodySize;
-	// size_t		_maxBodySize;
+	/*
+		Body sinks: _sink is NULL until the destination is known
+		(needsBodySink()), then points to one of the sinks below or to
+		an external one (streamBodyTo()).
+	*/
+	bool			_waitForSink;
+	BodySink*		_sink;
+	size_t			_maxBodySize;
+	MemoryBodySink	_memorySink;     // appends to _req.body
+	DiscardBodySink	_discardSink;
+	FileBodySink	_fileSink;
 
 	/*
 		Parsing helpers:
@@ -107,26 +181,31 @@ private:
 	bool	parseBodyChunked();  // parse chunked body
 
 	bool	finalizeHeaders();
-	bool	handleHeaderLine(const std::string &line);
-	bool	parseContentLengthValue(size_t &outValue, const std::string &value);
+	bool	handleHeaderLine(const char *line, const ByteScan::Line &scan);
+	NumberParse::Result	parseContentLengthValue(size_t &outValue, const HeaderView &value);
 
 	bool	parseChunkSizeLine();
-	bool	consumeFinalChunkCRLF();
+	bool	consumeTrailers();
 	bool	consumeChunkDataAndCRLF();
 
+	bool	writeBody(const char *data, size_t len);  // to _sink, 413 past _maxBodySize
+	bool	finishBody();                             // _sink->finish(), PS_DONE
+	void	useSink(BodySink *sink, size_t maxBodySize);
+	void	abortBody();                              // request dropped mid-body
+
 
 
 	/*
-		readLine(hasLine)
-		- Looks inside _buffer for "\r\n"
-		- If not found: hasLine = false, returns empty string (need more data)
-		- If found: extracts the line WITHOUT "\r\n", removes it from _buffer, hasLine = true
+		nextLine(line)
+		- Scans the input for the next "\r\n" (ByteScan, one pass that also
+		  records ':' and ' ' positions)
+		- If not found: returns false (need more data)
+		- If found: fills line (positions relative to _in->data()), returns true.
+		  The line is still in the input: the caller reads it in place, then
+		  calls consumeLine(line).
 	*/
-	std::string readLine(bool &hasLine);
-
-	// Small string utilities (static = they don't need object state)
-	static std::string trim(const std::string &s);       // removes spaces/tabs at both ends
-	static std::string toLower(const std::string &s);    // makes header names case-insensitive
+	bool	nextLine(ByteScan::Line &line);
+	void	consumeLine(const ByteScan::Line &line);
 
 	/*
 		setError(statusCode)
@@ -136,6 +215,10 @@ private:
 	*/
 	bool	setError(int statusCode);
 
+	// _in may point to _own: no copy
+	HttpRequestParser(const HttpRequestParser &);
+	HttpRequestParser &operator=(const HttpRequestParser &);
+
 };
 
 	bool	hasUnsafeSegments(const std::string& path);
@@ -20,26 +20,42 @@ class ResponseBuilder
 {
 public:
 	/*
-		build(resp, closeConnection)
+		build(out, resp, closeConnection)
 
+		- out : filled with the raw response (usually the Connection's
+		  send_buffer: no intermediate string, its capacity is reused)
 		- resp: status code, reason, headers, body
 		- closeConnection:
 			true  -> "Connection: close"
 			false -> "Connection: keep-alive"
 	*/
+	static void			build(std::string &out, const HttpResponse &resp, bool closeConnection);
+	// Same, returned by value (tests)
 	static std::string	build(const HttpResponse &resp, bool closeConnection);
 
-private:
 	/*
-		Returns a formatted Date header value.
-		Example: "Sun, 21 Dec 2025 09:00:00 GMT"
+		buildPrebuilt(out, resp)
+
+		The bytes of resp that build() would write after the Date header
+		(Server, Content-Length, headers, blank line, body), for
+		HttpResponse::prebuilt. A file body is not read: out ends with
+		the blank line and has room reserved for bodyLength more bytes.
+	*/
+	static void			buildPrebuilt(std::string &out, const HttpResponse &resp);
+
+	/*
+		Interim response for "Expect: 100-continue": the client sends the
+		body after it, the final response comes later on the same
+		connection (no headers, no body).
 	*/
-	static std::string	buildDateValue();
+	static const char	*const continueResponse;
 
+private:
 	/*
-		Convert size_t to string without std::to_string (not available in C++98).
+		Writes n in decimal just before end (no std::to_string in C++98,
+		no stringstream): returns the first digit.
 	*/
-	static std::string	toStringSize(size_t n);
+	static char			*writeSize(char *end, size_t n);
 };
 
 #endif
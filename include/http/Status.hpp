@@ -12,14 +12,18 @@ inline std::string reasonPhrase(int code)
 		case 204: return "No Content";
 		case 301: return "Moved Permanently";
 		case 302: return "Found";
+		case 304: return "Not Modified";
 		case 400: return "Bad Request";
 		case 403: return "Forbidden";
 		case 404: return "Not Found";
 		case 405: return "Method Not Allowed";
 		case 413: return "Payload Too Large";
+		case 417: return "Expectation Failed";
+		case 431: return "Request Header Fields Too Large";
 		case 500: return "Internal Server Error";
 		case 501: return "Not Implemented";
 		case 502: return "Bad Gateway";
+		case 503: return "Service Unavailable";
 		case 504: return "Gateway Timeout";
 	}
 	return "Error code not added to Status.hpp";
@@ -0,0 +1,46 @@
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <cstddef>
+#include <ctime>
+
+/*
+	Clock: the time, read once per event loop iteration.
+
+	Before, every response called time() + gmtime() + strftime() for its
+	Date header, every read re-armed its idle timer with clock_gettime()
+	and called time() again for last_activity. Now Server::run() calls
+	update() after each wait(), and everything handled in that iteration
+	uses the same values (like nginx's cached time):
+	- now_ms()  : monotonic, ms (timers: insensible aux changements d'heure)
+	- now()     : wall clock, s (last_activity, CGI start time)
+	- httpDate(): Date header value, regenerated at most once per second
+
+	Per thread: each reactor (worker_threads) has its own loop and its
+	own cached time. A thread that never called update() (tests, tools)
+	reads the clocks on first use.
+*/
+class Clock {
+public:
+	// "Sun, 21 Dec 2025 09:00:00 GMT"
+	static const size_t	HTTP_DATE_LEN = 29;
+
+	// Reads the clocks (Server::run(), after each wait())
+	static void					update();
+
+	static unsigned long long	now_ms();
+	static time_t				now();
+	// HTTP_DATE_LEN characters + '\0', valid until the next update() of this thread
+	static const char*			httpDate();
+
+	// Any time as an HTTP date (Last-Modified): false if t cannot be formatted
+	static bool					formatHttpDate(time_t t, char out[HTTP_DATE_LEN + 1]);
+	// HTTP date of a request header (If-Modified-Since): the 3 formats of
+	// RFC 9110 (IMF-fixdate, RFC 850, asctime), false if invalid
+	static bool					parseHttpDate(const char* s, size_t len, time_t& t);
+
+private:
+	Clock();
+};
+
+#endif
@@ -4,7 +4,12 @@
 #include <string>
 #include <stdexcept>
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <ctime>
+#include "TimerWheel.hpp"
+#include "RecvBuffer.hpp"
+#include "SharedBuffer.hpp"
 
 #define MAX_BODY_SIZE
 
@@ -12,6 +17,7 @@ class Connection {
 	public:
 //		CONSTRUCTORS & DESTRUCTOR
 
+		Connection();					// fd = -1, pour ObjectPool (voir attach())
 		explicit Connection(int fd);
 		~Connection();
 
@@ -19,21 +25,50 @@ class Connection {
 //		PUBLIC ATTRIBUTES
 
 		int 				fd;
-		static const size_t	maxRequestSize = 5 * 1024* 1024;
-		size_t				totalBytesReceived;
-		std::string			recv_buffer;
+		// Pas de plafond cumule par connexion: chaque requete a les siens
+		// (en-tetes: large_client_header_buffers du server, body: max_size de la
+		// location). Ici: requetes suivantes (pipelining) gardees pendant
+		// qu'une reponse part. Au-dela, on arrete de lire le socket
+		static const size_t	maxIdleBuffered = 64 * 1024;
+		static const size_t	RECV_CHUNK = 16 * 1024;	// place demandee a recv_buffer par recv()
+		static const size_t	RECV_DRAIN_MAX = 16 * RECV_CHUNK;	// max lu par drain (edge-triggered)
+		RecvBuffer			recv_buffer;	// recv() ecrit ici, le parser y lit en place
 		std::string			send_buffer;
 		size_t				bytes_sent;
+		// Body fichier (send_file()): part avec sendfile() apres send_buffer,
+		// qui reste non vide (= reponse en cours) jusqu'au dernier byte
+		int					file_fd;
+		off_t				file_offset;
+		size_t				file_remaining;
+		// Reponse du file cache (send_prebuilt()): part apres send_buffer,
+		// dans le meme sendmsg()
+		SharedBuffer		prebuilt;
+		size_t				prebuilt_sent;
 		time_t				last_activity;	// Timestamp de dernière activité (pour timeout)
 		bool				should_close;	// Fermer la connexion apres envoi (Connection: close)
+		bool				peer_closed;	// EOF recu pendant un drain (edge-triggered)
+		bool				drain_capped;	// drain arrete a RECV_DRAIN_MAX: il peut rester des donnees
+		bool				send_in_flight;	// envoi io_uring en cours (prepare_send()): buffers figes
+		TimerNode			idle_timer;		// timeout d'inactivite (TimerWheel du Server)
 
 
 //		MEMBER FUCTIONS
 
-		ssize_t read_available();
-		ssize_t write_pending();
+		ssize_t read_available(bool drain = false);
+		ssize_t write_pending(bool drain = false);
+		// Envoi par completion (io_uring): prepare_send() puis complete_send(resultat)
+		struct msghdr* prepare_send();
+		ssize_t complete_send(ssize_t n);
 		bool has_pending_data() const;
+		void send_file(int file, off_t offset, size_t length);
+		void send_prebuilt(const SharedBuffer& bytes);
 		void update_activity();
+		void arm_idle_timeout(TimerWheel* wheel, unsigned long long timeout_ms);
+
+		// ObjectPool: attach() donne un nouveau client a une connexion recyclee,
+		// recycle() ferme le fd et remet tout a zero (buffers gardes sous capacity_cap)
+		void attach(int fd);
+		void recycle(size_t capacity_cap);
 
 
 //		EXCEPTION CLASS
@@ -46,7 +81,15 @@ class Connection {
 
 	private:
 
-		void set_nonblocking();
+		void release_body();
+		int fill_iov(struct iovec* iov) const;
+		bool advance(size_t done);
+
+		struct msghdr		send_msg;		// prepare_send(): lu par le kernel a la soumission
+		struct iovec		send_iov[2];
+
+		TimerWheel*			timers;			// NULL = pas de timeout (tests)
+		unsigned long long	idle_timeout_ms;
 
 };
 
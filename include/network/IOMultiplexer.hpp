@@ -2,11 +2,35 @@
 #define IOMULTIPLEXER_HPP
 
 #include <vector>
-#include <map>
 #include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 #include <stdexcept>
 #include <string>
+#include "../configParser/Config.hpp"
+#include "IOUring.hpp"
 
+#ifdef __linux__
+# include <sys/epoll.h>
+#endif
+
+/*
+	IOMultiplexer hides the event backend behind one interface:
+
+	- BACKEND_POLL  : poll() over the whole fds vector, then a scan of revents
+	- BACKEND_EPOLL : epoll_wait() only returns the ready fds, so the cost of
+	                  one loop iteration scales with ready fds, not total fds
+	- BACKEND_IO_URING : one-shot POLL_ADD requests in an io_uring, plus
+	                  completion-based sends (submit_send(): SENDMSG).
+	                  All the (re)arms and sends of one loop iteration are
+	                  submitted together with the wait, in a single
+	                  io_uring_enter() syscall. recv() and sendfile() stay
+	                  plain syscalls made by the caller on readiness.
+	                  If io_uring_enter() fails for good, it switches to epoll
+
+	In all cases the caller uses poll() flags (POLLIN, POLLOUT, POLLHUP...),
+	epoll events are translated back and forth internally.
+*/
 class IOMultiplexer {
 public:
 	class MultiplexerException : public std::runtime_error {
@@ -14,16 +38,18 @@ public:
 		explicit MultiplexerException(const std::string& message);
 	};
 
-	IOMultiplexer();
+	// Si le backend demande n'est pas disponible, on retombe sur io_uring -> epoll -> poll()
+	explicit IOMultiplexer(EventBackend backend = BACKEND_POLL);
 	~IOMultiplexer();
 
 	// Ajoute un fd a surveiller avec les events specifies (POLLIN, POLLOUT, etc.)
-	void add_fd(int fd, short events);
+	// edge = true: EPOLLET (l'appelant doit tout lire/ecrire a chaque evenement)
+	void add_fd(int fd, short events, bool edge = false);
 
 	// Retire un fd de la surveillance
 	void remove_fd(int fd);
 
-	// Modifie les events surveilles pour un fd
+	// Modifie les events surveilles pour un fd (le mode edge est conserve)
 	void modify_fd(int fd, short events);
 
 	// Attend des evenements sur les fds surveilles
@@ -40,9 +66,65 @@ public:
 	// Nombre de fds surveilles
 	size_t size() const;
 
+	// Backend effectivement utilise
+	EventBackend backend() const;
+
+	// True si le backend sait faire du edge-triggered (epoll uniquement)
+	bool supports_edge_triggered() const;
+
+	// Nom lisible du backend (pour les logs)
+	const char* backend_name() const;
+
+	// io_uring: envoi par completion. msg (et les buffers de ses iovecs) doit
+	// rester valide jusqu'au resultat, ou jusqu'a remove_fd()
+	bool supports_async_send() const;
+	void submit_send(int fd, const struct msghdr* msg);
+
+	// Resultat d'un submit_send() arrive avec ce wait(), false s'il n'y en a pas.
+	// n > 0: bytes envoyes, 0: rien (socket plein, attendre POLLOUT), -1: erreur
+	bool send_result(int fd, ssize_t& n);
+
 private:
-	std::vector<struct pollfd> fds;
-	std::map<int, size_t> fd_to_index;
+	// Etat propre au backend, parallele a fds
+	struct EntryState {
+		bool				edge;		// EPOLLET
+		unsigned long long	armed_tag;	// io_uring: user_data du POLL_ADD en cours (0 = pas arme)
+		unsigned long long	send_tag;	// io_uring: user_data du SENDMSG en cours (0 = aucun)
+		unsigned			send_pos;	// io_uring: position du SENDMSG dans le ring de soumission
+		bool				send_done;	// resultat du send pas encore lu (send_result())
+		int					send_res;
+		bool				reported;	// deja dans le resultat de ce wait()
+	};
+
+	EventBackend				_backend;
+	int							epoll_fd;
+	IOUring						uring;
+	unsigned long long			uring_seq;	// rend chaque requete unique (completions perimees)
+
+	// Pour tous les backends: events demandes + revents du dernier wait()
+	std::vector<struct pollfd>	fds;
+	std::vector<EntryState>		state;
+	std::vector<int>			fd_to_index;	// indexe par fd: position dans fds, -1 = absent
+
+	std::vector<int>			last_ready;		// fds dont il faut remettre revents a 0
+	std::vector<int>			to_arm;			// io_uring: fds a (re)armer au prochain wait()
+	std::vector<int>			orphan_sends;	// io_uring abandonne: resultats a rendre au prochain wait()
+
+#ifdef __linux__
+	std::vector<struct epoll_event>	ready_events;	// buffer de sortie d'epoll_wait
+
+	void	epoll_control(int op, int fd, short events, bool edge_triggered);
+#endif
+	void	clear_last_ready();
+	int		index_of(int fd) const;
+	void	uring_disarm(size_t idx);
+	void	uring_failover(int err);
+	void	uring_reap(std::vector<int>* result);
+	unsigned long long	uring_tag(int fd);
+
+	std::vector<int>	wait_poll(int timeout);
+	std::vector<int>	wait_epoll(int timeout);
+	std::vector<int>	wait_uring(int timeout);
 
 	// Copie interdite
 	IOMultiplexer(const IOMultiplexer&);
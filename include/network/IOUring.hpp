@@ -0,0 +1,83 @@
+#ifndef IOURING_HPP
+#define IOURING_HPP
+
+#include <cstddef>
+
+struct msghdr;
+
+/*
+	Minimal io_uring wrapper (raw syscalls, no liburing).
+
+	Only what IOMultiplexer needs is exposed:
+	- prepare POLL_ADD / POLL_REMOVE / TIMEOUT / SENDMSG requests (no syscall,
+	  they are simply written into the shared submission ring)
+	- submit everything that was prepared AND wait for completions in
+	  one single io_uring_enter() call
+	- pop completions from the shared completion ring (no syscall)
+
+	init() returns false when the kernel (or a seccomp policy) does not
+	provide io_uring, so the caller can fall back to epoll/poll.
+*/
+class IOUring {
+public:
+	IOUring();
+	~IOUring();
+
+	// Cree et mappe les rings. false si io_uring n'est pas disponible
+	bool	init(unsigned entries);
+	bool	is_ready() const;
+
+	// 0, ou -errno si le ring est plein et n'a pas pu etre soumis (voir get_sqe)
+	int		prep_poll_add(int fd, short events, unsigned long long user_data);
+	int		prep_poll_remove(unsigned long long target, unsigned long long user_data);
+	int		prep_timeout(int timeout_ms, unsigned long long user_data);
+	// msg (et ses iovecs) doit rester valide jusqu'a la soumission
+	int		prep_sendmsg(int fd, const struct msghdr* msg, unsigned flags,
+						 unsigned long long user_data, unsigned& pos);
+	// SQE pas encore soumis -> NOP. false s'il a deja ete soumis
+	bool	cancel_unsubmitted(unsigned pos);
+
+	// Soumet les requetes preparees et attend min_complete completions
+	// Retourne 0, ou -errno si io_uring_enter() a echoue (-EINTR: signal,
+	// -EBUSY: ring de completion plein, il faut d'abord le vider)
+	int		submit_and_wait(unsigned min_complete);
+
+	// Depile une completion. false si le ring de completion est vide
+	bool	next_completion(unsigned long long& user_data, int& res);
+
+private:
+	int					ring_fd;
+	unsigned			pending;	// SQEs prepares mais pas encore soumis
+
+	// Submission ring
+	void*				sq_ptr;
+	size_t				sq_size;
+	unsigned*			sq_head;
+	unsigned*			sq_tail;
+	unsigned*			sq_mask;
+	unsigned*			sq_entries;
+	unsigned*			sq_array;
+	void*				sqes;
+	size_t				sqes_size;
+
+	// Completion ring
+	void*				cq_ptr;
+	size_t				cq_size;
+	unsigned*			cq_head;
+	unsigned*			cq_tail;
+	unsigned*			cq_mask;
+	void*				cqes;
+
+	// Timeout courant, meme layout que __kernel_timespec { tv_sec, tv_nsec }
+	// (doit rester valide jusqu'a la soumission)
+	long long			timeout_ts[2];
+
+	void*	get_sqe(int& err);
+	void	release();
+
+	// Copie interdite
+	IOUring(const IOUring&);
+	IOUring& operator=(const IOUring&);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef MASTERPROCESS_HPP
+#define MASTERPROCESS_HPP
+
+#include "../configParser/Config.hpp"
+#include <sys/types.h>
+#include <ctime>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+/*
+	MasterProcess implements `worker_processes N`.
+
+	The master binds every ServerBlock port once, then fork()s N workers.
+	Each worker builds its own Server on top of the inherited listening
+	sockets, so a crash or memory blowup in one worker (CGI, parser...)
+	never takes the others down, and Router/Config do not need to be
+	thread-safe.
+
+	The master never serves requests, it only supervises:
+	- SIGCHLD : a worker died -> it is restarted (throttled if it crashes
+	            right after starting)
+	- SIGHUP  : forwarded to the workers, which stop gracefully and are
+	            restarted with a fresh address space
+	- SIGINT / SIGTERM : forwarded to the workers, waits for them, exits
+*/
+class MasterProcess {
+public:
+	class MasterException : public std::runtime_error {
+	public:
+		explicit MasterException(const std::string& message);
+	};
+
+	// Ouvre tous les sockets d'ecoute (avant le premier fork)
+	explicit MasterProcess(const Config& cfg);
+	~MasterProcess();
+
+	// Lance les workers et les supervise jusqu'a SIGINT/SIGTERM
+	void run();
+
+private:
+	struct Worker {
+		pid_t	pid;
+		time_t	started;
+		time_t	respawn_at;	// slot vide: pas relance avant (0 = tout de suite)
+	};
+
+	const Config*		config;
+	std::vector<int>	listen_fds;	// listen_fds[i] <-> config->servers[i]
+	std::vector<Worker>	workers;
+
+	void	spawnWorker(size_t slot);
+	void	workerMain();
+	void	reapWorkers();
+	void	forwardSignal(int sig);
+
+	// Copie interdite
+	MasterProcess(const MasterProcess&);
+	MasterProcess& operator=(const MasterProcess&);
+};
+
+#endif
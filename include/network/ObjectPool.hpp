@@ -0,0 +1,102 @@
+#ifndef OBJECTPOOL_HPP
+#define OBJECTPOOL_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+	Free-list of recycled objects (Connection, HttpRequestParser, CgiProcess).
+
+	Under short-lived connection churn, every accept() used to do a `new`
+	and every removeClient() a `delete`, freeing the std::string buffers
+	with the object. The pool keeps released objects (and their buffers)
+	for the next acquire().
+
+	- T must be default-constructible and have recycle(size_t capacity_cap):
+	  it puts the object back in its default state, releasing any resource
+	  (fd, timer...) and any buffer grown beyond capacity_cap, so one huge
+	  upload does not stay pinned in the pool forever
+	- at most max_free objects are kept, the rest are deleted
+	- one pool per Server: no locking (worker_threads = one Server per thread)
+*/
+template <typename T>
+class ObjectPool {
+public:
+	struct Stats {
+		unsigned long	hits;		// acquire() servi par la free-list
+		unsigned long	misses;		// acquire() qui a du faire un new
+		unsigned long	discarded;	// release() avec free-list pleine (delete)
+	};
+
+	ObjectPool(size_t max_free, size_t capacity_cap)
+		: free_list(), max_free(max_free), capacity_cap(capacity_cap)
+	{
+		stats.hits = 0;
+		stats.misses = 0;
+		stats.discarded = 0;
+	}
+
+	~ObjectPool()
+	{
+		for (size_t i = 0; i < free_list.size(); i++)
+			delete free_list[i];
+	}
+
+	// Objet dans son etat par defaut (recycle() ou juste construit)
+	T* acquire()
+	{
+		if (free_list.empty())
+		{
+			stats.misses++;
+			return (new T());
+		}
+		stats.hits++;
+		T* obj = free_list.back();
+		free_list.pop_back();
+		return (obj);
+	}
+
+	// Rend obj au pool (NULL accepte, comme delete)
+	void release(T* obj)
+	{
+		if (obj == NULL)
+			return;
+		obj->recycle(capacity_cap);
+		if (free_list.size() >= max_free)
+		{
+			stats.discarded++;
+			delete obj;
+			return;
+		}
+		free_list.push_back(obj);
+	}
+
+	const Stats&	getStats() const { return (stats); }
+	size_t			freeCount() const { return (free_list.size()); }
+
+private:
+	std::vector<T*>	free_list;
+	size_t			max_free;
+	size_t			capacity_cap;
+	Stats			stats;
+
+	// Copie interdite
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+};
+
+/*
+	Vide buf pour reutilisation: la capacite est conservee tant qu'elle reste
+	sous capacity_cap, sinon la memoire est rendue (swap avec une chaine vide,
+	clear() seul ne libere rien).
+*/
+inline void recycleBuffer(std::string& buf, size_t capacity_cap)
+{
+	if (buf.capacity() > capacity_cap)
+		std::string().swap(buf);
+	else
+		buf.clear();
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef REACTORPOOL_HPP
+#define REACTORPOOL_HPP
+
+#include "Server.hpp"
+#include "../configParser/Config.hpp"
+#include <pthread.h>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+/*
+	ReactorPool runs `worker_threads N` independent reactors, one per thread.
+
+	Each reactor is a full Server: its own listening sockets (bound with
+	SO_REUSEPORT so the kernel load-balances new connections between them),
+	its own IOMultiplexer and its own connection/parser/CGI tables.
+	Nothing is shared between reactors except the Config, which is read-only
+	once parsed, so the request path needs no locking at all.
+
+	Signals: SIGINT is blocked in every thread and collected by the main
+	thread with sigwait(), which then stops each reactor and wakes it up
+	with SIGUSR1 (interrupts poll/epoll_wait/io_uring_enter with EINTR).
+*/
+class ReactorPool {
+public:
+	class PoolException : public std::runtime_error {
+	public:
+		explicit PoolException(const std::string& message);
+	};
+
+	// Cree les N Servers (les sockets sont ouverts ici, avant les threads)
+	explicit ReactorPool(const Config& cfg);
+	~ReactorPool();
+
+	// Demarre un thread par reactor et bloque jusqu'a SIGINT
+	void run();
+
+private:
+	struct Reactor {
+		Server*		server;
+		pthread_t	thread;
+		bool		started;
+	};
+
+	std::vector<Reactor>	reactors;
+
+	static void*	reactorMain(void* arg);
+	void			stopAll();
+	void			joinAll();
+
+	// Copie interdite
+	ReactorPool(const ReactorPool&);
+	ReactorPool& operator=(const ReactorPool&);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RECVBUFFER_HPP
+#define RECVBUFFER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+	Receive buffer of one connection, shared by Connection and its parser.
+
+	recv() writes straight into the free space at the end (prepare/commit),
+	the parser reads in place and consume()s what it has parsed: the bytes
+	are never copied from a stack buffer into Connection, then again into
+	the parser.
+
+		storage:  [ consumed | readable bytes | free space ]
+		          0          rpos             wpos         storage.size()
+
+	consume() only moves rpos, so parsing N small lines or chunks costs
+	O(N) instead of one memmove of the whole buffer per line. The readable
+	bytes are moved back to the front (compaction) only when prepare()
+	needs room at the end and the consumed prefix is at least as large
+	as them, or for free when everything has been consumed (rpos = wpos = 0).
+*/
+class RecvBuffer {
+public:
+	static const size_t	npos = static_cast<size_t>(-1);
+
+	RecvBuffer();
+
+	// Zone d'ecriture d'au moins n bytes a la fin (compacte ou agrandit si besoin)
+	char*		prepare(size_t n);
+	// Valide n bytes ecrits dans la zone rendue par prepare()
+	void		commit(size_t n);
+	// Copie data a la fin (parser utilise hors Server: tests)
+	void		append(const char* data, size_t n);
+
+	const char*	data() const;		// premier byte non consomme
+	size_t		size() const;		// bytes non consommes
+	bool		empty() const;
+	size_t		capacity() const;
+
+	// Marque les n premiers bytes comme lus (n <= size())
+	void		consume(size_t n);
+	void		clear();
+
+	// Position (depuis data()) du premier "\r\n" a partir de from, npos si absent
+	size_t		findCRLF(size_t from = 0) const;
+
+	// ObjectPool: vide le buffer, rend la memoire si capacity() > capacity_cap
+	void		recycle(size_t capacity_cap);
+
+private:
+	std::vector<char>	storage;
+	size_t				rpos;
+	size_t				wpos;
+};
+
+#endif
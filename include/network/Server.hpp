@@ -4,10 +4,13 @@
 #include "SocketManager.hpp"
 #include "Connection.hpp"
 #include "IOMultiplexer.hpp"
+#include "TimerWheel.hpp"
+#include "ObjectPool.hpp"
 #include "../http/RequestParser.hpp"
 #include "../http/ResponseBuilder.hpp"
 #include "../http/HttpResponse.hpp"
 #include "../router/Router.hpp"
+#include "../router/OpenFileCache.hpp"
 #include "../configParser/Config.hpp"
 #include "../cgi/CgiProcess.hpp"
 #include <map>
@@ -25,7 +28,12 @@ public:
 	};
 
 	// Constructeur: initialise le serveur avec une configuration (multi-ports)
-	explicit Server(const Config& cfg, int backlog = 128);
+	// reuse_port = true quand plusieurs reactors (worker_threads) ecoutent les memes ports
+	// La taille de la file listen() vient de chaque ServerBlock (`listen 8080 backlog=N;`)
+	explicit Server(const Config& cfg, bool reuse_port = false);
+
+	// Constructeur worker: reutilise des sockets deja ouverts (un par ServerBlock)
+	Server(const Config& cfg, const std::vector<int>& listen_fds);
 
 	// Destructeur: nettoie toutes les ressources
 	~Server();
@@ -41,13 +49,21 @@ private:
 	void acceptNewClient(int server_fd);
 	void handleClientRead(int fd);
 	void handleClientWrite(int fd);
+	void responseSent(int fd);          // Reponse partie: pipelining, fermeture ou keep-alive
+	void armWrite(int fd, short in);    // Reponse prete: SENDMSG io_uring, sinon POLLOUT
+	void handleSendDone(int fd, ssize_t n);  // Resultat d'un SENDMSG io_uring
 	void removeClient(int fd);
-	void checkClientTimeouts();  // Vérifie et ferme les connexions inactives
+	void startLingeringClose(int fd);   // SHUT_WR puis on jette le body restant avant close()
+	void handleLingeringRead(int fd);
+	void expireTimers();         // Ferme les clients inactifs et les CGI trop longs
 
 	// CGI non-bloquant
 	void handleCgiWrite(int pipe_fd);   // Ecrire body au CGI (POLLOUT sur pipe_in)
 	void handleCgiRead(int pipe_fd);    // Lire output du CGI (POLLIN sur pipe_out)
-	void checkCgiTimeouts();            // Verifier timeouts CGI
+	CgiProcess* launchCgi(int fd, const HttpRequest& req, const std::string& script_path,
+						  bool should_close);   // startCgi() + pipes dans le multiplexer (NULL = echec)
+	void updateCgiStdin(CgiProcess* cgi);      // POLLOUT sur pipe_in si bytes en attente, pause du client
+	void closeCgiStdin(CgiProcess* cgi);       // Tout le body ecrit: EOF pour le script
 	void finishCgi(CgiProcess* cgi);    // Terminer un CGI et envoyer reponse
 	void cleanupCgi(CgiProcess* cgi);   // Nettoyer un CGI (fermer pipes, kill process)
 	bool isCgiPipe(int fd) const;       // Verifier si fd est un pipe CGI
@@ -55,9 +71,53 @@ private:
 	// Helper: verifie si un fd est un server socket
 	bool isServerSocket(int fd) const;
 
+	// Compteurs des pools (affiches a l'arret)
+	template <typename T>
+	static void printPoolStats(const char* name, const ObjectPool<T>& pool);
+
+	// Type d'un fd surveille: run() fait un seul acces tableau par evenement
+	enum FdType {
+		FD_FREE,
+		FD_LISTEN,
+		FD_CLIENT,
+		FD_CGI_IN,      // stdin du CGI (on y ecrit le body)
+		FD_CGI_OUT      // stdout du CGI (on y lit la reponse)
+	};
+
+	// Tout ce que le Server sait d'un fd
+	struct FdSlot {
+		FdType				type;
+		Connection*			conn;		// FD_CLIENT
+		HttpRequestParser*	parser;		// FD_CLIENT (cree a la premiere requete)
+		const ServerBlock*	server;		// FD_LISTEN / FD_CLIENT
+		CgiProcess*			cgi;		// FD_CLIENT (CGI en cours) / FD_CGI_IN / FD_CGI_OUT
+		bool				body_to_cgi;	// FD_CLIENT: le body en cours de lecture va au stdin du CGI
+		bool				read_paused;	// FD_CLIENT: plus lu tant que le CGI a trop de retard
+		bool				answered_early;	// FD_CLIENT: reponse deja envoyee, le reste du body est jete
+		bool				closing;		// FD_CLIENT: reponse d'erreur envoyee, plus rien n'est parse
+		bool				lingering;		// FD_CLIENT: reponse envoyee + SHUT_WR, on lit jusqu'a close()
+		size_t				linger_bytes;	// FD_CLIENT: bytes jetes depuis le debut du lingering
+
+		FdSlot() : type(FD_FREE), conn(NULL), parser(NULL), server(NULL), cgi(NULL),
+			body_to_cgi(false), read_paused(false), answered_early(false),
+			closing(false), lingering(false), linger_bytes(0) {}
+	};
+
+	// Slot de fd (le tableau grandit si besoin: les references precedentes
+	// vers d'autres slots ne sont plus valides apres cet appel)
+	FdSlot& slot(int fd);
+	// Slot de fd s'il est du type demande, NULL sinon
+	FdSlot* findSlot(int fd, FdType type);
+	void releaseSlot(int fd);
+
 	// Processus de la donnee recue - utilise HttpRequestParser
 	void processRequest(Connection* conn, int fd);
 
+	// En-tetes lus: choisit ou va le body (Router::planBody) avant de le lire
+	void selectBodySink(int fd);
+	// Body accepte: envoie "100 Continue" si le client l'attend
+	void sendContinue(int fd);
+
 	// Traite une requete HTTP complete et retourne une reponse
 	// TODO: Plus tard, cette fonction appellera le Router
 	// HttpResponse handleHttpRequest(const HttpRequest& req);
@@ -65,21 +125,29 @@ private:
 	// Membres
 	SocketManager socket_manager;
 	IOMultiplexer multiplexer;
-	std::map<int, Connection*> clients;
-	std::map<int, HttpRequestParser*> parsers;  // Un parser par client (keep-alive)
-	std::map<int, const ServerBlock*> client_to_server; // client_fd → ServerBlock
+	TimerWheel timers;              // Timeouts clients (inactivite) + CGI
+	std::vector<FdSlot> slots;                      // Indexe par fd: clients, parsers, CGI, listen
+
+	// Objets recycles entre clients (pas de new/delete par connexion)
+	ObjectPool<Connection> conn_pool;
+	ObjectPool<HttpRequestParser> parser_pool;
+	ObjectPool<CgiProcess> cgi_pool;
+
+	// Petits fichiers statiques en memoire (`file_cache`, desactive par defaut)
+	FileCache file_cache;
+	// stat()/access()/open() des fichiers servis (`open_file_cache`, desactive par defaut)
+	OpenFileCache open_file_cache;
 
 	// Multi-port support
 	std::vector<int> server_fds;                    // Tous les server sockets
-	std::map<int, const ServerBlock*> fd_to_server; // fd → ServerBlock config
 	const Config* config;                           // Référence à la config complète
 
-	// CGI non-bloquant
-	std::map<int, CgiProcess*> cgi_by_pipe_in;      // pipe_in fd → CgiProcess
-	std::map<int, CgiProcess*> cgi_by_pipe_out;     // pipe_out fd → CgiProcess
-	std::map<int, CgiProcess*> cgi_by_client;       // client_fd → CgiProcess (pour savoir si client a un CGI en cours)
+	volatile bool running;	// stop() peut etre appele depuis un autre thread
+	bool edge_triggered;	// epoll + EPOLLET sur les sockets clients (drain a chaque event)
 
-	bool running;
+	// Compteurs (affiches a l'arret)
+	unsigned long stats_accepted;	// connexions acceptees
+	unsigned long stats_dropped;	// accept() en echec ou client non enregistre
 
 	// Copie interdite
 	Server(const Server&);
@@ -0,0 +1,75 @@
+#ifndef SHAREDBUFFER_HPP
+#define SHAREDBUFFER_HPP
+
+#include <cstddef>
+#include <string>
+
+/*
+	Read-only bytes shared through a reference count (no shared_ptr in
+	C++98).
+
+	The file cache keeps the serialized response of a small file in one
+	(HttpResponse::prebuilt). Every Connection sending it holds a copy:
+	a counter increment instead of a copy of the bytes, and an entry
+	evicted or replaced while responses are still in flight stays alive
+	until the last of them is sent.
+
+	The count is a plain integer: a buffer never leaves the reactor that
+	created it (worker_threads = one Server and one FileCache per thread).
+*/
+class SharedBuffer {
+public:
+	SharedBuffer() : block(NULL) {}
+	SharedBuffer(const SharedBuffer& other) : block(other.block)
+	{
+		if (block != NULL)
+			block->refs++;
+	}
+	~SharedBuffer() { release(); }
+
+	SharedBuffer&	operator=(const SharedBuffer& other)
+	{
+		if (other.block != NULL)
+			other.block->refs++;	// avant release(): auto-affectation
+		release();
+		block = other.block;
+		return (*this);
+	}
+
+	// Takes the content of bytes (swap, no copy): bytes is left empty
+	static SharedBuffer	adopt(std::string& bytes)
+	{
+		SharedBuffer	buf;
+
+		buf.block = new Block();
+		buf.block->refs = 1;
+		buf.block->bytes.swap(bytes);
+		return (buf);
+	}
+
+	const char*	data() const { return (block != NULL ? block->bytes.data() : NULL); }
+	size_t		size() const { return (block != NULL ? block->bytes.size() : 0); }
+	bool		empty() const { return (size() == 0); }
+
+	void		reset()
+	{
+		release();
+		block = NULL;
+	}
+
+private:
+	struct Block {
+		size_t		refs;
+		std::string	bytes;
+	};
+
+	void	release()
+	{
+		if (block != NULL && --block->refs == 0)
+			delete block;
+	}
+
+	Block*	block;
+};
+
+#endif
@@ -20,9 +20,12 @@ public:
 	~SocketManager();
 
 	// Crée un socket serveur complet (create + configure + bind + listen)
-	int create_server(int port, int backlog);
+	// reuse_port = true: SO_REUSEPORT, plusieurs sockets (un par reactor) peuvent
+	// ecouter sur le meme port, le kernel repartit les connexions entre eux
+	int create_server(int port, int backlog, bool reuse_port = false);
 
-	// Accepte une nouvelle connexion
+	// Accepte une nouvelle connexion (-1 si plus aucune connexion en attente)
+	// Le fd retourne est deja non-bloquant et close-on-exec (pas herite par les CGI)
 	int accept_connection(int server_fd);
 
 	// Ferme un socket
@@ -32,8 +35,8 @@ private:
 	// Crée un nouveau socket TCP
 	int create_socket();
 
-	// Configure le socket avec SO_REUSEADDR
-	void configure_socket(int fd);
+	// Configure le socket avec SO_REUSEADDR (+ SO_REUSEPORT si demande)
+	void configure_socket(int fd, bool reuse_port);
 
 	// Bind le socket à un port
 	void bind_socket(int fd, int port);
@@ -0,0 +1,78 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Intrusive timer, embedded in the object it times out
+ * (Connection, CgiProcess). Unlinked = not armed.
+ * @param kind what to do on expiry (see TimerWheel::Kind)
+ * @param fd client fd the timer belongs to (the CGI is found through it)
+ */
+struct TimerNode {
+	TimerNode*			prev;
+	TimerNode*			next;
+	unsigned long long	expires;	// deadline, ms (Clock::now_ms())
+	int					kind;
+	int					fd;
+
+	TimerNode() : prev(NULL), next(NULL), expires(0), kind(0), fd(-1) {}
+
+	bool	armed() const { return (next != NULL); }
+};
+
+/*
+	Hashed timer wheel: SLOTS buckets of TICK_MS each, a node goes into the
+	bucket of its deadline tick (modulo SLOTS, later "rounds" simply stay in
+	the bucket until their deadline is reached).
+
+	- schedule()/cancel() are O(1): unlink + push in a doubly linked list,
+	  so Connection::update_activity() can re-arm on every read (deadlines
+	  from Clock::now_ms(): no clock read per schedule())
+	- expire() only visits the buckets of the ticks elapsed since the last
+	  call, instead of scanning every client and every CGI
+	- next_timeout() gives the delay to the first non-empty bucket, used as
+	  the poll/epoll/io_uring timeout, so deadlines fire within one tick
+*/
+class TimerWheel {
+public:
+	enum Kind {
+		TIMER_CLIENT_IDLE,	// Connection inactive trop longtemps
+		TIMER_CGI			// CGI trop long (504)
+	};
+
+	static const unsigned	SLOTS = 512;
+	static const unsigned	TICK_MS = 32;
+
+	TimerWheel();
+	~TimerWheel();
+
+	// (Re)arme node pour expirer dans delay_ms
+	void	schedule(TimerNode& node, unsigned long long delay_ms);
+
+	// Desarme node (sans effet s'il ne l'est pas)
+	void	cancel(TimerNode& node);
+
+	// Delai en ms avant le prochain bucket non vide, -1 si aucun timer
+	int		next_timeout(unsigned long long now) const;
+
+	// Desarme et retourne (dans expired) tous les timers dont la deadline est passee
+	void	expire(unsigned long long now, std::vector<TimerNode*>& expired);
+
+	size_t	size() const;
+
+private:
+	TimerNode			slots[SLOTS];	// sentinelles de listes circulaires
+	unsigned long long	current_tick;	// dernier tick traite par expire()
+	size_t				count;
+
+	void	link(TimerNode& head, TimerNode& node);
+	void	unlink(TimerNode& node);
+
+	// Copie interdite
+	TimerWheel(const TimerWheel&);
+	TimerWheel& operator=(const TimerWheel&);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef FILECACHE_HPP
+#define FILECACHE_HPP
+
+#include <cstddef>
+#include <string>
+#include <list>
+#include <map>
+#include <sys/stat.h>
+#include "network/SharedBuffer.hpp"
+
+/*
+	In-memory cache of small static files (`file_cache` directive).
+
+	Hot assets (css, favicon, index pages) were opened and read on every
+	GET. A cached file is served from memory: one stat() to validate it,
+	no open()/read().
+
+	- an entry holds the 200 response, serialized once when the file was
+	  read: everything after the Date header (Server, Content-Length,
+	  Content-Type, ETag, Last-Modified, blank line, body). A hit only writes the status
+	  line, Connection and Date (ResponseBuilder::build()), the Connection
+	  sends both parts with one sendmsg(). Evicted entries stay alive
+	  until the responses still sending them are done (SharedBuffer)
+	- valid while the file keeps the same inode, size, mtime and ctime
+	  (ctime also catches a chmod: a cached file never skips access())
+	- LRU: a hit moves the entry to the front, inserting past max_bytes
+	  evicts from the back. Files bigger than max_entry are never cached
+	  (sent with sendfile() instead), nor files modified during the
+	  current second (maybe still being written, weak ETag)
+	- one cache per Server: no locking (worker_threads = one Server per
+	  thread), so the budget applies per reactor
+*/
+class FileCache {
+public:
+	static const size_t	DEFAULT_MAX_ENTRY = 256 * 1024;
+
+	struct Entry {
+		std::string		path;
+		SharedBuffer	response;	// HttpResponse::prebuilt of the file
+		size_t			bodyOffset;	// body = response from bodyOffset
+		std::string		contentType;
+		std::string		etag;
+		std::string		lastModified;
+		struct stat		st;			// stat() of the file when it was read
+	};
+
+	struct Stats {
+		unsigned long	hits;		// lookup() servi depuis la memoire
+		unsigned long	misses;		// fichier absent du cache ou modifie depuis
+		unsigned long	evictions;	// entrees sorties pour tenir max_bytes
+	};
+
+	// max_bytes = 0: cache desactive (enabled() == false)
+	FileCache(size_t max_bytes, size_t max_entry);
+
+	bool			enabled() const { return (max_bytes > 0); }
+
+	// Entry of path if cached and still matching st (stat() of path), NULL otherwise
+	const Entry*	lookup(const std::string& path, const struct stat& st);
+	// Reads the regular file fd (st = its fstat()) into the cache: NULL if
+	// it is too big or the read fails (the caller keeps using fd)
+	const Entry*	insert(const std::string& path, int fd, const struct stat& st);
+
+	/*
+		Validators of a static file (conditional GET, see Router::notModified()):
+		- ETag: "inode-mtime-size" in hex. Weak (W/"...") while the file was
+		  modified during the current second: a second write in that same
+		  second could keep inode, mtime and size, so the bytes are not
+		  guaranteed to match the tag
+		- Last-Modified: mtime as an HTTP date
+	*/
+	static std::string	makeETag(const struct stat& st);
+	static std::string	makeLastModified(const struct stat& st);
+
+	const Stats&	getStats() const { return (stats); }
+	size_t			size() const { return (index.size()); }
+	size_t			bytes() const { return (used); }
+
+private:
+	typedef std::list<Entry>							EntryList;
+	typedef std::map<std::string, EntryList::iterator>	EntryIndex;
+
+	void			erase(EntryIndex::iterator it);
+	static size_t	cost(const Entry& e);
+	static bool		sameFile(const struct stat& a, const struct stat& b);
+
+	EntryList	lru;		// front = most recently used
+	EntryIndex	index;		// path -> entry in lru
+	size_t		max_bytes;
+	size_t		max_entry;
+	size_t		used;
+	Stats		stats;
+
+	// Copie interdite
+	FileCache(const FileCache&);
+	FileCache& operator=(const FileCache&);
+};
+
+#endif
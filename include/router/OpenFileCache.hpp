@@ -0,0 +1,104 @@
+#ifndef OPENFILECACHE_HPP
+#define OPENFILECACHE_HPP
+
+#include <cstddef>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <sys/stat.h>
+
+/*
+	Cache of stat() results, access() checks and open fds, keyed by
+	resolved path (`open_file_cache` directive, like nginx's).
+
+	A GET used to call stat() up to four times through the PathUtils
+	predicates (exists, isFile, isDir), access() for the permission checks,
+	then open() + fstat(); a directory GET repeated this for every index
+	candidate. With the cache, the first predicate on a path does the
+	stat(), the others (and the open(), see openFile() in PathUtils) reuse
+	it.
+
+	- an entry is valid for `valid` seconds (Clock::now_ms(), no syscall),
+	  failed stat() included (404s are cached too)
+	- inotify watches the directory of each entry: any change in that
+	  directory (write, create, delete, rename, chmod) drops its entries.
+	  Events are read once per loop iteration (sync(), from Server::run()),
+	  the TTL covers what inotify cannot see (changes above the parent
+	  directory, no inotify available)
+	- open fds: openFile() hands out a duplicate (F_DUPFD_CLOEXEC) that the
+	  caller closes; the cached fd is closed with its entry
+	- at most max_entries entries (so at most max_entries cached fds), LRU
+	- one cache per Server, installed per thread (install()): the PathUtils
+	  functions use the cache of their thread, plain syscalls without one
+*/
+class OpenFileCache {
+public:
+	static const unsigned	DEFAULT_VALID_SEC = 5;
+
+	struct Stats {
+		unsigned long	hits;			// lookups servies sans syscall
+		unsigned long	misses;			// stat() fait (absent ou expire)
+		unsigned long	invalidations;	// entrees retirees par inotify ou invalidate()
+		unsigned long	evictions;		// entrees sorties pour tenir max_entries
+	};
+
+	// max_entries = 0: cache desactive (enabled() == false)
+	OpenFileCache(size_t max_entries, unsigned valid_sec);
+	~OpenFileCache();
+
+	bool			enabled() const { return (max_entries > 0); }
+
+	// Cache used by the PathUtils functions of the calling thread (NULL = none)
+	static void				install(OpenFileCache* cache);
+	static OpenFileCache*	current();
+
+	// Same results as the syscalls, from the cache when possible
+	bool	stat(const std::string& path, struct stat& st);	// stat() == 0
+	bool	access(const std::string& path, int mode);			// access() == 0
+	int		open(const std::string& path, struct stat& st);		// new fd (O_RDONLY) or -1
+
+	// Path changed by the server itself (upload, DELETE): drop it now
+	void	invalidate(const std::string& path);
+	// Reads the pending inotify events (once per loop iteration)
+	void	sync();
+
+	const Stats&	getStats() const { return (stats); }
+	size_t			size() const { return (index.size()); }
+
+private:
+	struct Entry {
+		std::string			path;
+		bool				ok;				// stat() a reussi
+		struct stat			st;
+		int					fd;				// ouvert au premier open(), -1 sinon
+		int					access_known;	// bits R_OK/W_OK/X_OK deja testes
+		int					access_ok;		// ... et autorises
+		unsigned long long	checked_ms;		// date du stat()
+		int					wd;				// watch inotify du dossier parent, -1 sinon
+	};
+
+	typedef std::list<Entry>							EntryList;
+	typedef std::map<std::string, EntryList::iterator>	EntryIndex;
+	typedef std::map<int, std::set<std::string> >		WatchMap;	// wd -> chemins
+
+	Entry*	lookup(const std::string& path);
+	void	watch(Entry& e);
+	void	erase(EntryIndex::iterator it);
+	void	dropWatch(int wd, bool removed_by_kernel);
+	void	clear();
+
+	EntryList			lru;		// front = most recently used
+	EntryIndex			index;		// path -> entry in lru
+	WatchMap			watches;
+	size_t				max_entries;
+	unsigned long long	valid_ms;
+	int					inotify_fd;	// -1: TTL only
+	Stats				stats;
+
+	// Copie interdite
+	OpenFileCache(const OpenFileCache&);
+	OpenFileCache& operator=(const OpenFileCache&);
+};
+
+#endif
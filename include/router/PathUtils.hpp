@@ -4,6 +4,7 @@
 #include <cstring>		// strerror
 #include <unistd.h>     // access()
 #include <errno.h>      // errno
+#include <sys/stat.h>   // struct stat
 #include "colours.hpp"
 #include <iostream>
 
@@ -32,6 +33,14 @@ std::string	getResolvedPath(const std::string& urlPath, const std::string& rules
 std::string	getResolvedErrorPagePath(const std::string& errorPagePath, const std::string& serverRoot);
 
 
+/*
+	Filesystem checks, through the OpenFileCache of the thread if any
+	(same results as the syscalls, see OpenFileCache.hpp).
+*/
+bool	statPath(const std::string& p, struct stat& st);
+int		openFile(const std::string& p, struct stat& st);
+void	invalidatePath(const std::string& p);
+
 bool	exists(const std::string& p);
 bool	isDir(const std::string& p);
 bool	isFile(const std::string& p);
@@ -8,6 +8,7 @@
 #include "configParser/LocationBlock.hpp"
 #include "configParser/ServerBlock.hpp"
 #include "router/PathUtils.hpp"
+#include "router/FileCache.hpp"
 #include <set>
 #include <vector>
 #include <iostream>
@@ -56,10 +57,34 @@ typedef std::set<std::string, std::greater<std::string> > DescendingStrSet;
 
 
 
+/**
+ * @brief Where the body of a request goes, decided by Router::planBody()
+ * once its headers are parsed (the Server hands it to the parser).
+ * @param maxBodySize bodies of this size or more are rejected (413)
+ * @param path upload file (BODY_UPLOAD_FILE) or CGI script (BODY_CGI)
+ */
+struct BodyPlan {
+	enum Target {
+		BODY_MEMORY,		// HttpRequest::body, as before
+		BODY_DISCARD,		// the response does not depend on the body
+		BODY_REJECT,		// error/redirect decided from the headers: answer before the body
+		BODY_UPLOAD_FILE,	// POST upload, written as it arrives
+		BODY_CGI			// stdin of the CGI, started right away
+	};
+
+	Target		target;
+	size_t		maxBodySize;
+	std::string	path;
+
+	BodyPlan() : target(BODY_MEMORY), maxBodySize(static_cast<size_t>(-1)), path() {}
+};
+
+
+
 class Router {
 
 	public:
-		Router(const Config& cfg, const ServerBlock* serverBlock);
+		Router(const Config& cfg, const ServerBlock* serverBlock, FileCache* fileCache = NULL);
 		~Router();
 
 //---------------------------------------------------------------------------//
@@ -71,6 +96,8 @@ class Router {
 	const ServerBlock	*server;//		Pointer to ServerBlock matching HTTP request
 	const LocationBlock	*rules;//		Pointer to LocationBlock matching HTTP request
 	LocationBlock		defaultLoc;//	Only used if "/" is not configured in Config
+	FileCache			*fileCache;//	Static files kept in memory by the Server (NULL = off)
+	const HttpRequest	*request;//		Request being routed (conditional GET headers)
 
 //---------------------------------------------------------------------------//
 //								FUNCTIONS
@@ -80,6 +107,7 @@ class Router {
 	HttpResponse		buildResponse(const HttpRequest& req);
 	HttpResponse		buildRedirectResponse(const int& code, const std::string& target);
 	HttpResponse		routing(const HttpRequest& req);
+	BodyPlan			planBody(const HttpRequest& req);
 
 
 //						SERVE ERROR PAGE
@@ -94,6 +122,7 @@ class Router {
 	DescendingStrSet	genParentPaths(const std::string& uri);
 	bool				methodAllowed(const HttpMethod& method);
 	bool				exceedsMaxSize(const size_t& len);
+	static size_t		bodySize(const HttpRequest& req);
 	bool				isCgiRequest(const HttpRequest& req) const;
 
 //---------------------------------------------------------------------------//
@@ -106,6 +135,10 @@ class Router {
 		*/
 	HttpResponse	handleGet(const std::string& urlPath);
 	bool			readFileToString(const std::string& path, std::string& responseBody);
+	bool			openFileBody(const std::string& path, HttpResponse& resp);
+	bool			fromFileCache(const std::string& path, HttpResponse& resp);
+	bool			notModified(const std::string& etag, time_t mtime) const;
+	bool			notModifiedFile(const std::string& path, HttpResponse& resp);
 	HttpResponse	getServeFile(const std::string& resolvedPath);
 	HttpResponse	getTryIndexFiles(const std::string& resolvedPath,
 						const std::vector<std::string>& indexList);
@@ -117,7 +150,8 @@ class Router {
 //								POST & DELETE
 
 	HttpResponse	handleDelete(const std::string& urlPath);
-	HttpResponse	handlePost(const HttpRequest& req);;
+	HttpResponse	handlePost(const HttpRequest& req);
+	HttpResponse	uploadTarget(const HttpRequest& req, std::string& filename, std::string& fullPath);
 };
 
 
@@ -0,0 +1,36 @@
+#include "../../include/cgi/CgiBodySink.hpp"
+#include "../../include/cgi/CgiProcess.hpp"
+
+CgiBodySink::CgiBodySink()
+	: _cgi(NULL)
+{}
+
+void CgiBodySink::attach(CgiProcess* cgi)
+{
+	_cgi = cgi;
+}
+
+bool CgiBodySink::write(const char* data, size_t len)
+{
+	if (_cgi == NULL)
+		return false;
+
+	// Drop the part already written to the pipe once it is larger than
+	// what is still queued (each byte is moved at most once on average)
+	if (_cgi->body_written > 0
+		&& _cgi->body_written >= _cgi->body.size() - _cgi->body_written)
+	{
+		_cgi->body.erase(0, _cgi->body_written);
+		_cgi->body_written = 0;
+	}
+	_cgi->body.append(data, len);
+	return true;
+}
+
+bool CgiBodySink::finish(HttpRequest&)
+{
+	if (_cgi == NULL)
+		return false;
+	_cgi->body_complete = true;
+	return true;
+}
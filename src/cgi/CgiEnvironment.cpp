@@ -1,6 +1,6 @@
 #include "../../include/cgi/CgiEnvironment.hpp"
 #include "../../include/cgi/CgiUtils.hpp"
-#include <map>
+#include <cstring>
 
 std::vector<std::string> CgiEnvironment::buildEnvironment(const HttpRequest& req,
 														  const std::string& scriptPath)
@@ -28,10 +28,10 @@ std::vector<std::string> CgiEnvironment::buildEnvironment(const HttpRequest& req
 	env.push_back("SERVER_PROTOCOL=" + req.httpVersion);
 
 	// CONTENT_TYPE
-	std::map<std::string, std::string>::const_iterator ct_it = req.headers.find("content-type");
-	if (ct_it != req.headers.end())
+	HeaderView content_type = req.headers.get(HeaderTable::H_CONTENT_TYPE);
+	if (content_type.present())
 	{
-		env.push_back("CONTENT_TYPE=" + ct_it->second);
+		env.push_back("CONTENT_TYPE=" + content_type.str());
 	}
 
 	// CONTENT_LENGTH
@@ -45,34 +45,40 @@ std::vector<std::string> CgiEnvironment::buildEnvironment(const HttpRequest& req
 	}
 
 	// HTTP_* headers (convert all request headers to CGI format)
-	for (std::map<std::string, std::string>::const_iterator it = req.headers.begin();
-		 it != req.headers.end(); ++it)
+	// (read in place from the header table, one string built per variable)
+	for (size_t h = 0; h < req.headers.size(); h++)
 	{
+		if (req.headers.overridden(h))
+			continue;  // duplicate header: the last one wins
 
-		std::string key = it->first;
-		std::string value = it->second;
+		HeaderView key = req.headers.name(h);
+		HeaderView value = req.headers.value(h);
 
 		// Convert header name to uppercase with HTTP_ prefix
 		// Example: "user-agent" -> "HTTP_USER_AGENT"
-		std::string env_key = "HTTP_";
-		for (size_t i = 0; i < key.size(); i++)
+		std::string env_var;
+		env_var.reserve(5 + key.size + 1 + value.size);
+		env_var += "HTTP_";
+		for (size_t i = 0; i < key.size; i++)
 		{
-			char c = key[i];
+			char c = key.data[i];
 			if (c == '-')
 			{
-				env_key += '_';
+				env_var += '_';
 			}
 			else if (c >= 'a' && c <= 'z')
 			{
-				env_key += (c - 'a' + 'A');  // Convert to uppercase
+				env_var += (c - 'a' + 'A');  // Convert to uppercase
 			}
 			else
 			{
-				env_key += c;
+				env_var += c;
 			}
 		}
+		env_var += '=';
+		env_var.append(value.data, value.size);
 
-		env.push_back(env_key + "=" + value);
+		env.push_back(env_var);
 	}
 
 	// SERVER_SOFTWARE
@@ -82,19 +88,19 @@ std::vector<std::string> CgiEnvironment::buildEnvironment(const HttpRequest& req
 	env.push_back("GATEWAY_INTERFACE=CGI/1.1");
 
 	// SERVER_NAME and SERVER_PORT (from Host header)
-	std::map<std::string, std::string>::const_iterator host_it = req.headers.find("host");
-	if (host_it != req.headers.end())
+	HeaderView host = req.headers.get(HeaderTable::H_HOST);
+	if (host.present())
 	{
-		std::string host = host_it->second;
-		size_t colon_pos = host.find(':');
-		if (colon_pos != std::string::npos)
+		const char* colon = static_cast<const char*>(std::memchr(host.data, ':', host.size));
+		if (colon != NULL)
 		{
-			env.push_back("SERVER_NAME=" + host.substr(0, colon_pos));
-			env.push_back("SERVER_PORT=" + host.substr(colon_pos + 1));
+			size_t colon_pos = colon - host.data;
+			env.push_back("SERVER_NAME=" + std::string(host.data, colon_pos));
+			env.push_back("SERVER_PORT=" + std::string(colon + 1, host.size - colon_pos - 1));
 		}
 		else
 		{
-			env.push_back("SERVER_NAME=" + host);
+			env.push_back("SERVER_NAME=" + host.str());
 			env.push_back("SERVER_PORT=80");
 		}
 	}
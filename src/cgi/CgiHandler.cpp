@@ -3,11 +3,13 @@
 #include "../../include/cgi/CgiParser.hpp"
 #include "../../include/cgi/CgiUtils.hpp"
 #include "../../include/http/Status.hpp"
+#include "../../include/network/Clock.hpp"
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <cerrno>
+#include <csignal>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
@@ -29,7 +31,8 @@ CgiProcess* CgiHandler::startCgi(const HttpRequest& req,
 								 const std::string& scriptPath,
 								 int client_fd,
 								 const std::string& interpreterPath,
-								 int timeout)
+								 int timeout,
+								 CgiProcess* into)
 {
 	// Verify script exists
 	if (access(scriptPath.c_str(), F_OK) != 0)
@@ -134,6 +137,14 @@ CgiProcess* CgiHandler::startCgi(const HttpRequest& req,
 		argv[1] = const_cast<char*>(scriptName.c_str());
 		argv[2] = NULL;
 
+		// Le masque et les signaux ignores survivent a execve(): le thread
+		// reactor bloque SIGINT (ReactorPool) et main() ignore SIGPIPE,
+		// le script doit repartir avec l'etat par defaut
+		sigset_t empty;
+		sigemptyset(&empty);
+		sigprocmask(SIG_SETMASK, &empty, NULL);
+		signal(SIGPIPE, SIG_DFL);
+
 		// Execute CGI script
 		execve(interpreter.c_str(), argv, &env_ptrs[0]);
 
@@ -161,20 +172,25 @@ CgiProcess* CgiHandler::startCgi(const HttpRequest& req,
 		return NULL;
 	}
 
-	// Create CgiProcess structure
-	CgiProcess* cgi = new CgiProcess();
+	// Fill the caller's CgiProcess (pooled) or create one
+	CgiProcess* cgi = (into != NULL) ? into : new CgiProcess();
 	cgi->pid = pid;
 	cgi->pipe_in = pipe_in[1];
 	cgi->pipe_out = pipe_out[0];
 	cgi->client_fd = client_fd;
+	// Body not received yet (started once the headers were parsed): the
+	// parser queues it through cgi->stdin_sink as it arrives
+	bool streamBody = req.hasContentLength && !req.chunked
+		&& req.bodyBytesRead < req.contentLength;
 	cgi->body = req.body;
 	cgi->body_written = 0;
+	cgi->body_complete = !streamBody;
 	cgi->output = "";
-	cgi->start_time = time(NULL);
+	cgi->start_time = Clock::now();
 	cgi->timeout = timeout;
 
 	// If no body to write, start in reading state and close pipe_in
-	if (cgi->body.empty())
+	if (cgi->body.empty() && cgi->body_complete)
 	{
 		close(cgi->pipe_in);
 		cgi->pipe_in = -1;
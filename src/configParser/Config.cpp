@@ -1,6 +1,15 @@
 #include "configParser/Config.hpp"
 
 Config::Config(const std::string& configFile)
+	: eventBackend(BACKEND_POLL),
+	  edgeTriggered(false),
+	  workerThreads(1),
+	  workerProcesses(0),
+	  acceptBatch(64),
+	  fileCacheSize(0),
+	  fileCacheMaxEntry(0),
+	  openFileCacheMax(0),
+	  openFileCacheValid(0)
 {
 	std::ifstream file(configFile.c_str());
 	if (!file.is_open())
@@ -30,14 +39,25 @@ Config::Config(const std::string& configFile)
 			throw std::runtime_error("One or more Server Blocks are missing the `root` directive");
 	}
 	detectDuplicatePorts(this->servers);
+
+	if (this->workerThreads > 1 && this->workerProcesses > 0)
+		throw std::runtime_error("`worker_threads` and `worker_processes` cannot be combined");
 }
 
 
 // Copy Assignment Constructor
 Config::Config(const Config& other)
-{
-	this->servers = other.servers;
-}
+	: servers(other.servers),
+	  eventBackend(other.eventBackend),
+	  edgeTriggered(other.edgeTriggered),
+	  workerThreads(other.workerThreads),
+	  workerProcesses(other.workerProcesses),
+	  acceptBatch(other.acceptBatch),
+	  fileCacheSize(other.fileCacheSize),
+	  fileCacheMaxEntry(other.fileCacheMaxEntry),
+	  openFileCacheMax(other.openFileCacheMax),
+	  openFileCacheValid(other.openFileCacheValid)
+{}
 
 // Assignment Constructor
 Config&	Config::operator=(const Config& other)
@@ -45,6 +65,15 @@ Config&	Config::operator=(const Config& other)
 if (this != &other)
 {
 	this->servers = other.servers;
+	this->eventBackend = other.eventBackend;
+	this->edgeTriggered = other.edgeTriggered;
+	this->workerThreads = other.workerThreads;
+	this->workerProcesses = other.workerProcesses;
+	this->acceptBatch = other.acceptBatch;
+	this->fileCacheSize = other.fileCacheSize;
+	this->fileCacheMaxEntry = other.fileCacheMaxEntry;
+	this->openFileCacheMax = other.openFileCacheMax;
+	this->openFileCacheValid = other.openFileCacheValid;
 }
 return (*this);
 }
@@ -18,6 +18,8 @@ ConfigParser::ConfigParser(const std::vector<Token>& toks)
 	serverDirectives["max_size"] = &ConfigParser::parseMaxSize;
 	serverDirectives["location"] = &ConfigParser::parseLocationBlock;
 	serverDirectives["upload"] = &ConfigParser::parseUpload;
+	serverDirectives["large_client_header_buffers"] = &ConfigParser::parseLargeClientHeaderBuffers;
+	serverDirectives["max_headers"] = &ConfigParser::parseMaxHeaders;
 
 //build map for Location directives(KEY) to function pointers(VALUE)
 	locationDirectives["root"] = &ConfigParser::parseRoot;
@@ -31,6 +33,15 @@ ConfigParser::ConfigParser(const std::vector<Token>& toks)
 	locationDirectives["cgi_bin"] = &ConfigParser::parseCgiBin;
 	locationDirectives["cgi_extension"] = &ConfigParser::parseCgiExtension;
 
+//build map for global directives(KEY) to function pointers(VALUE)
+	globalDirectives["event_backend"] = &ConfigParser::parseEventBackend;
+	globalDirectives["edge_triggered"] = &ConfigParser::parseEdgeTriggered;
+	globalDirectives["worker_threads"] = &ConfigParser::parseWorkerThreads;
+	globalDirectives["worker_processes"] = &ConfigParser::parseWorkerProcesses;
+	globalDirectives["accept_batch"] = &ConfigParser::parseAcceptBatch;
+	globalDirectives["file_cache"] = &ConfigParser::parseFileCache;
+	globalDirectives["open_file_cache"] = &ConfigParser::parseOpenFileCache;
+
 }
 
 ConfigParser::~ConfigParser() {}
@@ -46,14 +57,18 @@ ConfigParser::~ConfigParser() {}
  * 1 by 1 and adding them progressively to `data.server`
  * @param data The main Config object
  * @note `data` has a member `servers` which is a vector storing all the
- * ServerBlocks that were built during parsing
+ * ServerBlocks that were built during parsing. Any top-level word that is
+ * not `server` is treated as a global directive (see parseGlobalDirectives.cpp)
  */
 void	ConfigParser::parse(Config& data)
 {
 
 	while (!isAtEnd())
 	{
-		data.servers.push_back(parseServerBlock());
+		if (checkWord("server"))
+			data.servers.push_back(parseServerBlock());
+		else
+			parseGlobalDirective(data);
 	}
 	//[DEBUG] output to see all parsed/stored values
 	// printAllOutput(data);
@@ -1,15 +1,20 @@
 #include "configParser/ServerBlock.hpp"
+#include "http/RequestParser.hpp"
 
 /**
  * @brief Default Constructor - Builds a ServerBlock object setting default values
- * for `port`, `autoIndex` and `clientMaxBodySize`
+ * for `port`, `autoIndex`, `clientMaxBodySize` and the request head limits
  */
 ServerBlock::ServerBlock() :
 	hasPort(false),
 	hasRoot(false),
 	port(0),
+	backlog(128),
 	autoIndex(false),
-	clientMaxBodySize(512 * 1024UL)
+	clientMaxBodySize(512 * 1024UL),
+	headerLineMax(HttpRequestParser::DEFAULT_MAX_LINE),
+	headerTotalMax(HttpRequestParser::DEFAULT_MAX_HEADER_SIZE),
+	maxHeaders(HttpRequestParser::DEFAULT_MAX_HEADERS)
 {
 	defaultMethods.push_back("GET");
 }
@@ -0,0 +1,288 @@
+#include "configParser/ConfigParser.hpp"
+#include "router/FileCache.hpp"
+#include "router/OpenFileCache.hpp"
+#include <unistd.h>
+
+//---------------------------------------------------------------------------//
+//						  PARSE GLOBAL DIRECTIVE
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief Parses a single top-level directive (i.e. one that is written
+ * outside of any `server` block) and stores it in the `Config` object.
+ * These directives tune the server process itself rather than a given
+ * ServerBlock, e.g. which event backend IOMultiplexer should use.
+ */
+void	ConfigParser::parseGlobalDirective(Config& c)
+{
+	Token	directive = expect(TOKEN_WORD, "Expected directive");
+
+// Find pointer to parsing function that matches directive.value
+	std::map<std::string, GlobalFn>::iterator	it =
+		globalDirectives.find(Mime::toLower(directive.value));
+
+// If directive not found in map, throw error
+	if (it == globalDirectives.end())
+		throw ParseException("Unkown directive: ", directive);
+
+// Else call function pointer to parse directive
+	(this->*(it->second))(c);
+}
+
+
+//---------------------------------------------------------------------------//
+//								  ON / OFF
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief Converts an `on`/`off` token to a boolean, throws on anything else
+ */
+bool	ConfigParser::parseOnOff(const Token& valueToken)
+{
+	if (valueToken.value == "on")
+		return (true);
+	if (valueToken.value == "off")
+		return (false);
+	throw ParseException("Unknown boolean:", valueToken);
+}
+
+
+//---------------------------------------------------------------------------//
+//							  EVENT BACKEND
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `event_backend poll|epoll|io_uring;`
+ * @note epoll and io_uring are Linux only. IOMultiplexer falls back
+ * io_uring -> epoll -> poll when the requested backend is unavailable
+ * io_uring sends in-memory responses with SENDMSG (batched with the wait),
+ * recv() and sendfile() bodies stay readiness-based (POLL_ADD)
+ */
+void	ConfigParser::parseEventBackend(Config& c)
+{
+	Token	backendToken = expect(TOKEN_WORD, "Expected event backend (poll, epoll or io_uring)");
+	std::string	backend = Mime::toLower(backendToken.value);
+
+	if (backend == "poll")
+		c.eventBackend = BACKEND_POLL;
+	else if (backend == "epoll")
+		c.eventBackend = BACKEND_EPOLL;
+	else if (backend == "io_uring")
+		c.eventBackend = BACKEND_IO_URING;
+	else
+		throw ParseException("Unknown event backend:", backendToken);
+
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+//---------------------------------------------------------------------------//
+//							  EDGE TRIGGERED
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `edge_triggered on|off;` Client sockets are registered with EPOLLET
+ * and drained on every event. Ignored by the poll backend.
+ */
+void	ConfigParser::parseEdgeTriggered(Config& c)
+{
+	Token	valueToken = expect(TOKEN_WORD, "Expected on/off");
+
+	c.edgeTriggered = parseOnOff(valueToken);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+//---------------------------------------------------------------------------//
+//								  COUNT
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief Converts a token to an integer in [min, max], throws on anything else
+ */
+long	ConfigParser::parseCount(const Token& valueToken, long min, long max)
+{
+	std::stringstream	ss(valueToken.value);
+	long	n;
+
+	if (!(ss >> n) || !ss.eof())
+		throw ParseException("not a number:", valueToken);
+	if (n < min || n > max)
+	{
+		std::stringstream	range;
+		range << "out of range [" << min << "-" << max << "]:";
+		throw ParseException(range.str(), valueToken);
+	}
+	return (n);
+}
+
+
+//---------------------------------------------------------------------------//
+//							  WORKER THREADS
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `worker_threads N|auto;` Runs N independent reactors (one thread,
+ * one IOMultiplexer and one SO_REUSEPORT listening socket per port each).
+ * `auto` = one reactor per online CPU
+ */
+void	ConfigParser::parseWorkerThreads(Config& c)
+{
+	Token	valueToken = expect(TOKEN_WORD, "Expected number of threads or 'auto'");
+
+	c.workerThreads = parseWorkerCount(valueToken);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+//---------------------------------------------------------------------------//
+//							  WORKER PROCESSES
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `worker_processes N|auto;` main() becomes a master that binds the
+ * ports once and supervises N forked workers (see MasterProcess.hpp)
+ * @note cannot be combined with `worker_threads`
+ */
+void	ConfigParser::parseWorkerProcesses(Config& c)
+{
+	Token	valueToken = expect(TOKEN_WORD, "Expected number of processes or 'auto'");
+
+	c.workerProcesses = parseWorkerCount(valueToken);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+/**
+ * @brief Number of workers in [1-64], `auto` = one per online CPU
+ */
+int	ConfigParser::parseWorkerCount(const Token& valueToken)
+{
+	if (Mime::toLower(valueToken.value) != "auto")
+		return (parseCount(valueToken, 1, 64));
+
+	long	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus < 1)
+		return (1);
+	return (static_cast<int>(cpus > 64 ? 64 : cpus));
+}
+
+
+//---------------------------------------------------------------------------//
+//							   ACCEPT BATCH
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `accept_batch N;` A readable listening socket is drained with up to
+ * N accept() calls before going back to the event loop, so a burst of
+ * connections does not overflow the listen backlog
+ */
+void	ConfigParser::parseAcceptBatch(Config& c)
+{
+	Token	valueToken = expect(TOKEN_WORD, "Expected number of connections");
+
+	c.acceptBatch = parseCount(valueToken, 1, 65535);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+//---------------------------------------------------------------------------//
+//								FILE CACHE
+//---------------------------------------------------------------------------//
+
+// Size and unit from getSizeAndUnit() -> bytes
+static size_t	toBytes(long num, const std::string& unit)
+{
+	size_t	size = static_cast<size_t>(num);
+
+	if (unit == "K")
+		size *= 1024UL;
+	else if (unit == "M")
+		size *= 1024UL * 1024UL;
+	else if (unit == "G")
+		size *= 1024UL * 1024UL * 1024UL;
+	return (size);
+}
+
+/**
+ * @brief `file_cache off | size [max_entry];` Keeps small static files in
+ * memory (see FileCache.hpp): up to `size` bytes per reactor, files bigger
+ * than `max_entry` (default 256K) are always sent from disk
+ * @note a size without unit is in M, like max_size
+ */
+void	ConfigParser::parseFileCache(Config& c)
+{
+	Token		sizeToken = expect(TOKEN_WORD, "Expected cache size or 'off'");
+	long		num;
+	std::string	unit;
+
+	if (Mime::toLower(sizeToken.value) == "off")
+	{
+		c.fileCacheSize = 0;
+		expect(TOKEN_SEMICOLON, "Expected ';'");
+		return ;
+	}
+	getSizeAndUnit(sizeToken, num, unit);
+	c.fileCacheSize = toBytes(num, unit);
+	if (c.fileCacheSize > 1024UL * 1024UL * 1024UL)
+		throw ParseException("file_cache size too large (max 1G):", sizeToken);
+
+	c.fileCacheMaxEntry = FileCache::DEFAULT_MAX_ENTRY;
+	if (!check(TOKEN_SEMICOLON))
+	{
+		Token	entryToken = expect(TOKEN_WORD, "Expected max entry size");
+
+		getSizeAndUnit(entryToken, num, unit);
+		c.fileCacheMaxEntry = toBytes(num, unit);
+	}
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+//---------------------------------------------------------------------------//
+//							  OPEN FILE CACHE
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `open_file_cache off | max=N [valid=S];` Keeps up to N stat()
+ * results, access() checks and open fds of static files per reactor (see
+ * OpenFileCache.hpp). A result is redone after S seconds (default 5) or
+ * as soon as inotify reports a change in its directory
+ * @note each cached file holds one fd: keep N well under `ulimit -n`
+ */
+void	ConfigParser::parseOpenFileCache(Config& c)
+{
+	Token	first = expect(TOKEN_WORD, "Expected max=N or 'off'");
+
+	if (Mime::toLower(first.value) == "off")
+	{
+		c.openFileCacheMax = 0;
+		expect(TOKEN_SEMICOLON, "Expected ';'");
+		return ;
+	}
+	c.openFileCacheValid = OpenFileCache::DEFAULT_VALID_SEC;
+
+	Token	param = first;
+	while (true)
+	{
+		Token	value = param;
+
+		if (param.value.compare(0, 4, "max=") == 0)
+		{
+			value.value = param.value.substr(4);
+			c.openFileCacheMax = parseCount(value, 1, 100000);
+		}
+		else if (param.value.compare(0, 6, "valid=") == 0)
+		{
+			value.value = param.value.substr(6);
+			c.openFileCacheValid = parseCount(value, 1, 3600);
+		}
+		else
+			throw ParseException("Unknown open_file_cache parameter:", param);
+		if (!check(TOKEN_WORD))
+			break ;
+		param = consume();
+	}
+	if (c.openFileCacheMax == 0)
+		throw ParseException("open_file_cache: missing max=N", first);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
@@ -109,6 +109,54 @@ void	ConfigParser::parseMaxSize(ServerBlock& s)
 
 
 
+//---------------------------------------------------------------------------//
+//								HEADER LIMITS
+//---------------------------------------------------------------------------//
+
+/**
+ * @brief `large_client_header_buffers N size;` (as in nginx): the request line
+ * and each header line must fit in `size` (400 / 431 otherwise), the whole
+ * head in N * size (431). Checked per request, while the head arrives.
+ * @note size takes the same units as `max_size`, between 1K and 1M
+ */
+void	ConfigParser::parseLargeClientHeaderBuffers(ServerBlock& s)
+{
+	Token		countToken = expect(TOKEN_WORD, "Expected number of buffers");
+	long		count = parseCount(countToken, 1, 64);
+	long		num;
+	std::string	unit;
+	Token		sizeToken = expect(TOKEN_WORD, "Expected buffer size");
+
+	getSizeAndUnit(sizeToken, num, unit);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+
+	size_t		size = static_cast<size_t>(num);
+	if (unit == "K")
+		size *= 1024UL;
+	else if (unit == "M")
+		size *= 1024UL * 1024UL;
+	else if (unit == "G")
+		size *= 1024UL * 1024UL * 1024UL;
+
+	if (size < 1024 || size > 1024 * 1024)
+		throw ParseException("buffer size out of range [1K-1M]:", sizeToken);
+	s.headerLineMax = size;
+	s.headerTotalMax = size * static_cast<size_t>(count);
+}
+
+/**
+ * @brief `max_headers N;` max number of header lines in one request (431)
+ */
+void	ConfigParser::parseMaxHeaders(ServerBlock& s)
+{
+	Token	valueToken = expect(TOKEN_WORD, "Expected number of headers");
+
+	s.maxHeaders = parseCount(valueToken, 1, 10000);
+	expect(TOKEN_SEMICOLON, "Expected ';'");
+}
+
+
+
 //---------------------------------------------------------------------------//
 //								AUTO INDEX
 //---------------------------------------------------------------------------//
@@ -214,6 +262,18 @@ void	ConfigParser::parseListen(ServerBlock& s)
 
 // consume port number
 	consume();
+
+// optional parameters: backlog=N
+	while (check(TOKEN_WORD))
+	{
+		Token	param = consume();
+
+		if (param.value.compare(0, 8, "backlog=") != 0)
+			throw ParseException("Unknown listen parameter:", param);
+		Token	value = param;
+		value.value = param.value.substr(8);
+		s.backlog = parseCount(value, 1, 65535);
+	}
 	expect(TOKEN_SEMICOLON, "Expected ';'");
 	s.port = port;
 	s.hasPort = true;
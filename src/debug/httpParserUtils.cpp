@@ -41,12 +41,11 @@ void	printHttpHeaders(const HttpRequest& req)
 {
 	std::cout << CYAN << "[HEADERS]" << std::endl;
 
-	std::map<std::string, std::string>::const_iterator it = req.headers.begin();
-	for (; it != req.headers.end(); ++it)
+	for (size_t i = 0; i < req.headers.size(); ++i)
 		std::cout << std::setw(8)
-			<< MAGENTA << it->first
+			<< MAGENTA << req.headers.name(i).str()
 			<< RES << ":"
-			<< GREEN << it->second
+			<< GREEN << req.headers.value(i).str()
 			<< RES << std::endl;
 }
 
@@ -0,0 +1,130 @@
+#include "http/BodySink.hpp"
+#include "http/Request.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+	BodySink
+*/
+
+BodySink::~BodySink() {}
+
+bool	BodySink::finish(HttpRequest &)
+{
+	return (true);
+}
+
+void	BodySink::abort() {}
+
+/*
+	MemoryBodySink
+*/
+
+MemoryBodySink::MemoryBodySink(std::string &body)
+	: _body(body)
+{}
+
+bool	MemoryBodySink::write(const char *data, size_t len)
+{
+	_body.append(data, len);
+	return (true);
+}
+
+/*
+	DiscardBodySink
+*/
+
+bool	DiscardBodySink::write(const char *, size_t)
+{
+	return (true);
+}
+
+/*
+	FileBodySink
+*/
+
+FileBodySink::FileBodySink()
+	: _fd(-1), _path(), _tmpPath()
+{}
+
+// Upload jamais termine (parser detruit en cours de body): pas de fichier temporaire oublie
+FileBodySink::~FileBodySink()
+{
+	abort();
+}
+
+void	FileBodySink::close()
+{
+	if (_fd >= 0)
+		::close(_fd);
+	_fd = -1;
+}
+
+/*
+	The body goes to a hidden temporary file next to the target
+	("dir/.name.upload-XXXXXX"): the target is only replaced by finish(),
+	with rename() (same directory, same filesystem: atomic). An upload
+	that fails halfway (413, client gone, bad chunk) leaves an existing
+	file untouched.
+*/
+bool	FileBodySink::open(const std::string &path)
+{
+	abort();
+	size_t	slash = path.rfind('/');
+	size_t	base = (slash == std::string::npos) ? 0 : slash + 1;
+
+	_path = path;
+	_tmpPath = path.substr(0, base) + "." + path.substr(base) + ".upload-XXXXXX";
+	_fd = mkostemp(&_tmpPath[0], O_CLOEXEC);
+	if (_fd < 0)
+		return (false);
+	// mkstemp() cree en 0600: memes droits qu'un upload ecrit directement
+	fchmod(_fd, 0644);
+	return (true);
+}
+
+// Fichier regulier: write() ne renvoie jamais EAGAIN, on boucle sur les ecritures partielles
+bool	FileBodySink::write(const char *data, size_t len)
+{
+	while (len > 0)
+	{
+		if (_fd < 0)
+			return (false);
+		ssize_t n = ::write(_fd, data, len);
+		if (n <= 0)
+			return (false);
+		data += n;
+		len -= n;
+	}
+	return (true);
+}
+
+bool	FileBodySink::finish(HttpRequest &req)
+{
+	struct stat	st;
+
+	if (_fd < 0)
+		return (false);
+	close();
+	req.uploadExisted = (stat(_path.c_str(), &st) == 0);	// 200 instead of 201
+	if (rename(_tmpPath.c_str(), _path.c_str()) != 0)
+	{
+		unlink(_tmpPath.c_str());
+		_tmpPath.clear();
+		return (false);
+	}
+	_tmpPath.clear();
+	req.uploadPath = _path;
+	return (true);
+}
+
+void	FileBodySink::abort()
+{
+	close();
+	if (!_tmpPath.empty())
+		unlink(_tmpPath.c_str());
+	_tmpPath.clear();
+}
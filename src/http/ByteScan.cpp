@@ -0,0 +1,217 @@
+#include "http/ByteScan.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+# define BYTESCAN_X86 1
+# include <immintrin.h>
+#else
+# define BYTESCAN_X86 0
+#endif
+
+ByteScan::Impl	ByteScan::_impl = ByteScan::detect();
+
+ByteScan::Impl	ByteScan::detect()
+{
+#if BYTESCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (IMPL_AVX2);
+	return (IMPL_SSE2);
+#else
+	return (IMPL_SCALAR);
+#endif
+}
+
+ByteScan::Impl	ByteScan::implementation()
+{
+	return (_impl);
+}
+
+// Benchmarks only: forcer une implementation absente du CPU = SIGILL
+void	ByteScan::forceImplementation(Impl impl)
+{
+#if !BYTESCAN_X86
+	impl = IMPL_SCALAR;
+#endif
+	_impl = impl;
+}
+
+const char	*ByteScan::implementationName(Impl impl)
+{
+	if (impl == IMPL_AVX2)
+		return ("avx2");
+	if (impl == IMPL_SSE2)
+		return ("sse2");
+	return ("scalar");
+}
+
+bool	ByteScan::scanLine(const char *p, size_t len, size_t from, Line &line)
+{
+	if (_impl == IMPL_AVX2)
+		return (scanAvx2(p, len, from, line));
+	if (_impl == IMPL_SSE2)
+		return (scanSse2(p, len, from, line));
+	return (scanScalar(p, len, from, line));
+}
+
+/*
+	visit(pos): p[pos] is '\r', ':' or ' '.
+	Returns true when it is the "\r\n" that ends the line.
+	A byte may be visited twice when a scan is resumed (the last byte of
+	the previous scan is rescanned, it may be a '\r' waiting for its '\n'),
+	hence the "pos > space1" check.
+*/
+bool	ByteScan::visit(const char *p, size_t len, size_t pos, Line &line)
+{
+	char	c = p[pos];
+
+	if (c == '\r')
+	{
+		if (pos + 1 < len && p[pos + 1] == '\n')
+		{
+			line.length = pos;
+			return (true);
+		}
+	}
+	else if (c == ':')
+	{
+		if (line.colon == npos)
+			line.colon = pos;
+	}
+	else if (line.space1 == npos)
+		line.space1 = pos;
+	else if (line.space2 == npos && pos > line.space1)
+		line.space2 = pos;
+	return (false);
+}
+
+// Tous les delimiteurs utiles sont connus: seule la fin de ligne reste a trouver
+bool	ByteScan::complete(const Line &line)
+{
+	return (line.colon != npos && line.space2 != npos);
+}
+
+// Fin de ligne seulement (memchr de la libc est deja vectorise)
+bool	ByteScan::scanCr(const char *p, size_t len, size_t from, Line &line)
+{
+	while (from < len)
+	{
+		const void *cr = std::memchr(p + from, '\r', len - from);
+		if (cr == NULL)
+			return (false);
+		size_t pos = static_cast<const char *>(cr) - p;
+		if (visit(p, len, pos, line))
+			return (true);
+		from = pos + 1;
+	}
+	return (false);
+}
+
+bool	ByteScan::scanScalar(const char *p, size_t len, size_t from, Line &line)
+{
+	for (size_t i = from; i < len; i++)
+	{
+		if (complete(line))
+			return (scanCr(p, len, i, line));
+		char c = p[i];
+		if ((c == '\r' || c == ':' || c == ' ') && visit(p, len, i, line))
+			return (true);
+	}
+	return (false);
+}
+
+#if BYTESCAN_X86
+
+bool	ByteScan::scanSse2(const char *p, size_t len, size_t from, Line &line)
+{
+	const __m128i	cr = _mm_set1_epi8('\r');
+	const __m128i	colon = _mm_set1_epi8(':');
+	const __m128i	space = _mm_set1_epi8(' ');
+	size_t			i = from;
+
+	if (complete(line))
+		return (scanCr(p, len, i, line));
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i	v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+		__m128i	hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cr),
+								_mm_cmpeq_epi8(v, colon)), _mm_cmpeq_epi8(v, space));
+		unsigned	mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+
+		while (mask != 0)
+		{
+			size_t pos = i + __builtin_ctz(mask);
+			if (visit(p, len, pos, line))
+				return (true);
+			if (complete(line))
+				return (scanCr(p, len, pos + 1, line));
+			mask &= mask - 1;
+		}
+	}
+	return (scanScalar(p, len, i, line));
+}
+
+/*
+	Avance bloc par bloc (32 bytes) jusqu'au premier bloc contenant un
+	delimiteur: retourne sa position et son masque (mask = 0: plus de bloc
+	complet). vzeroupper avant de rendre la main: le code appelant (visit,
+	memchr, scanSse2) est du SSE, et l'executer avec la moitie haute des
+	registres ymm sale coute une penalite de transition a chaque appel.
+*/
+__attribute__((target("avx2")))
+static size_t	avx2NextBlock(const char *p, size_t len, size_t i, unsigned &mask)
+{
+	const __m256i	cr = _mm256_set1_epi8('\r');
+	const __m256i	colon = _mm256_set1_epi8(':');
+	const __m256i	space = _mm256_set1_epi8(' ');
+
+	mask = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i	v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+		__m256i	hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, cr),
+								_mm256_cmpeq_epi8(v, colon)), _mm256_cmpeq_epi8(v, space));
+		mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+		if (mask != 0)
+			break;
+	}
+	_mm256_zeroupper();
+	return (i);
+}
+
+bool	ByteScan::scanAvx2(const char *p, size_t len, size_t from, Line &line)
+{
+	size_t		i = from;
+	unsigned	mask;
+
+	if (complete(line))
+		return (scanCr(p, len, i, line));
+	while ((i = avx2NextBlock(p, len, i, mask)) + 32 <= len)
+	{
+		while (mask != 0)
+		{
+			size_t pos = i + __builtin_ctz(mask);
+			if (visit(p, len, pos, line))
+				return (true);
+			if (complete(line))
+				return (scanCr(p, len, pos + 1, line));
+			mask &= mask - 1;
+		}
+		i += 32;
+	}
+	return (scanSse2(p, len, i, line));
+}
+
+#else
+
+bool	ByteScan::scanSse2(const char *p, size_t len, size_t from, Line &line)
+{
+	return (scanScalar(p, len, from, line));
+}
+
+bool	ByteScan::scanAvx2(const char *p, size_t len, size_t from, Line &line)
+{
+	return (scanScalar(p, len, from, line));
+}
+
+#endif
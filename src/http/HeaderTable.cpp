@@ -0,0 +1,184 @@
+#include "http/HeaderTable.hpp"
+#include <cstring>
+
+static char	lowerAscii(char c)
+{
+	if (c >= 'A' && c <= 'Z')
+		return (static_cast<char>(c - 'A' + 'a'));
+	return (c);
+}
+
+/*
+	HeaderView
+*/
+
+std::string	HeaderView::str() const
+{
+	if (data == NULL)
+		return (std::string());
+	return (std::string(data, size));
+}
+
+bool	HeaderView::equals(const char *lower) const
+{
+	size_t	len = std::strlen(lower);
+
+	if (data == NULL || size != len)
+		return (false);
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (lowerAscii(data[i]) != lower[i])
+			return (false);
+	}
+	return (true);
+}
+
+bool	HeaderView::containsNoCase(const char *lower) const
+{
+	size_t	len = std::strlen(lower);
+
+	if (data == NULL || len > size)
+		return (false);
+	for (size_t start = 0; start + len <= size; ++start)
+	{
+		size_t i = 0;
+		while (i < len && lowerAscii(data[start + i]) == lower[i])
+			++i;
+		if (i == len)
+			return (true);
+	}
+	return (false);
+}
+
+/*
+	HeaderTable
+*/
+
+// Noms des en-tetes connus, dans l'ordre de l'enum Known
+static const char	*g_knownNames[HeaderTable::H_COUNT] = {
+	"host",
+	"content-length",
+	"content-type",
+	"transfer-encoding",
+	"connection",
+	"expect",
+	"if-none-match",
+	"if-modified-since"
+};
+
+HeaderTable::HeaderTable()
+	: _arena(), _fields()
+{
+	for (int k = 0; k < H_COUNT; ++k)
+		_known[k] = -1;
+}
+
+int	HeaderTable::knownIndex(const char *lowerName, size_t len)
+{
+	for (int k = 0; k < H_COUNT; ++k)
+	{
+		if (std::strlen(g_knownNames[k]) == len
+			&& std::memcmp(g_knownNames[k], lowerName, len) == 0)
+			return (k);
+	}
+	return (-1);
+}
+
+void	HeaderTable::add(const char *name, size_t nameLen, const char *value, size_t valueLen)
+{
+	Field	f;
+
+	f.nameOff = _arena.size();
+	f.nameLen = nameLen;
+	f.valueOff = f.nameOff + nameLen;
+	f.valueLen = valueLen;
+
+	_arena.resize(f.valueOff + valueLen);
+	for (size_t i = 0; i < nameLen; ++i)
+		_arena[f.nameOff + i] = lowerAscii(name[i]);
+	if (valueLen > 0)
+		std::memcpy(&_arena[f.valueOff], value, valueLen);
+
+	int k = knownIndex(&_arena[f.nameOff], nameLen);
+	if (k >= 0)
+		_known[k] = static_cast<int>(_fields.size());
+	_fields.push_back(f);
+}
+
+void	HeaderTable::clear()
+{
+	_arena.clear();
+	_fields.clear();
+	for (int k = 0; k < H_COUNT; ++k)
+		_known[k] = -1;
+}
+
+void	HeaderTable::recycle(size_t capacityCap)
+{
+	clear();
+	if (_arena.capacity() > capacityCap)
+		std::vector<char>().swap(_arena);
+}
+
+size_t	HeaderTable::size() const
+{
+	return (_fields.size());
+}
+
+bool	HeaderTable::empty() const
+{
+	return (_fields.empty());
+}
+
+HeaderView	HeaderTable::name(size_t i) const
+{
+	const Field	&f = _fields[i];
+
+	return (HeaderView(f.nameLen ? &_arena[f.nameOff] : "", f.nameLen));
+}
+
+HeaderView	HeaderTable::value(size_t i) const
+{
+	const Field	&f = _fields[i];
+
+	return (HeaderView(f.valueLen ? &_arena[f.valueOff] : "", f.valueLen));
+}
+
+bool	HeaderTable::overridden(size_t i) const
+{
+	const Field	&f = _fields[i];
+
+	for (size_t j = i + 1; j < _fields.size(); ++j)
+	{
+		if (_fields[j].nameLen == f.nameLen
+			&& std::memcmp(&_arena[_fields[j].nameOff], &_arena[f.nameOff], f.nameLen) == 0)
+			return (true);
+	}
+	return (false);
+}
+
+bool	HeaderTable::has(Known k) const
+{
+	return (_known[k] >= 0);
+}
+
+HeaderView	HeaderTable::get(Known k) const
+{
+	if (_known[k] < 0)
+		return (HeaderView());
+	return (value(_known[k]));
+}
+
+// Depuis la fin: le dernier doublon gagne
+HeaderView	HeaderTable::find(const char *lowerName) const
+{
+	size_t	len = std::strlen(lowerName);
+
+	for (size_t i = _fields.size(); i > 0; --i)
+	{
+		const Field	&f = _fields[i - 1];
+		if (f.nameLen == len && (len == 0 || std::memcmp(&_arena[f.nameOff], lowerName, len) == 0))
+			return (value(i - 1));
+	}
+	return (HeaderView());
+}
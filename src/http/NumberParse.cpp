@@ -0,0 +1,52 @@
+#include "http/NumberParse.hpp"
+
+static const size_t	SIZE_MAX_VALUE = static_cast<size_t>(-1);
+
+NumberParse::Result	NumberParse::decimal(const char *p, size_t len, size_t &out)
+{
+	bool	overflow = false;
+
+	out = 0;
+	if (len == 0)
+		return (NUM_INVALID);
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (p[i] < '0' || p[i] > '9')
+			return (NUM_INVALID);
+		size_t digit = static_cast<size_t>(p[i] - '0');
+		// On continue apres un depassement: "999...9x" reste invalide (400)
+		if (overflow || out > (SIZE_MAX_VALUE - digit) / 10)
+			overflow = true;
+		else
+			out = out * 10 + digit;
+	}
+	return (overflow ? NUM_OVERFLOW : NUM_OK);
+}
+
+NumberParse::Result	NumberParse::hex(const char *p, size_t len, size_t &out)
+{
+	bool	overflow = false;
+
+	out = 0;
+	if (len == 0)
+		return (NUM_INVALID);
+	for (size_t i = 0; i < len; ++i)
+	{
+		size_t	digit;
+		char	c = p[i];
+
+		if (c >= '0' && c <= '9')
+			digit = static_cast<size_t>(c - '0');
+		else if (c >= 'a' && c <= 'f')
+			digit = static_cast<size_t>(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F')
+			digit = static_cast<size_t>(c - 'A' + 10);
+		else
+			return (NUM_INVALID);
+		if (overflow || out > (SIZE_MAX_VALUE >> 4))
+			overflow = true;
+		else
+			out = (out << 4) | digit;
+	}
+	return (overflow ? NUM_OVERFLOW : NUM_OK);
+}
@@ -1,25 +1,27 @@
 #include "http/RequestParser.hpp"
 #include <cctype>
-#include <sstream>
+#include <cstring>
+#include "http/NumberParse.hpp"
 
 bool	HttpRequestParser::parseBody()
 {
 	/*
-		We only implement Content-Length body parsing in this step.
-
 		At this point:
 		- Headers are already parsed.
-		- parseHeaders() decided there IS a body, and set _state = PS_BODY.
+		- finalizeHeaders() decided there IS a body, and set _state = PS_BODY.
 		- _req.hasContentLength / _req.contentLength is already set.
 
-		We need to collect exactly _req.contentLength bytes from _buffer.
-		When done, we set PS_DONE.
+		We need to pass exactly _req.contentLength bytes from the input to
+		the body sink. When done, we set PS_DONE.
 	*/
 
 	/*
-		If request is chunked, we are NOT implementing it yet.
-		We will do chunked in Phase 3.5.TODO
+		No sink yet: the Server has to route the request first
+		(needsBodySink()). The body stays in the input meanwhile.
 	*/
+	if (_sink == NULL)
+		return (false);
+
 	if (_req.chunked == true)
 		return (parseBodyChunked());
 
@@ -30,45 +32,122 @@ bool	HttpRequestParser::parseBody()
 	if (_req.hasContentLength == false)
 		return (setError(400));
 
-	//	If Content-Length is 0, body is empty and we are done immediately.
-
-	if (_req.contentLength == 0)
-	{
-		_state = PS_DONE;
-		return (true);
-	}
+	//	Whole body already received (or Content-Length: 0): we are done.
+	if (_req.bodyBytesRead == _req.contentLength)
+		return (finishBody());
 
 	/*
 		We may not have all body bytes yet.
-		We only take what's available in _buffer and wait for more if needed.
+		We only take what's available in the input and wait for more if needed.
 	*/
 	{
 		size_t	remaining;
 		size_t	canTake;
 
-		remaining = _req.contentLength - _req.body.size();
-		if (_buffer.size() == 0)
+		remaining = _req.contentLength - _req.bodyBytesRead;
+		if (_in->size() == 0)
 			return (false);
-		if (_buffer.size() < remaining)
-			canTake = _buffer.size();
+		if (_in->size() < remaining)
+			canTake = _in->size();
 		else
 			canTake = remaining;
 
-		//	Append body bytes to _req.body.
-		_req.body.append(_buffer, 0, canTake);
+		//	Hand the body bytes to the sink (error state already set on failure).
+		if (writeBody(_in->data(), canTake) == false)
+			return (true);
 
-		//	Remove consumed bytes from _buffer.
-		_buffer.erase(0, canTake);
+		//	Consume them from the input.
+		_in->consume(canTake);
 	}
-	//	If we collected the full body, we're done.
+	//	If we passed on the full body, we're done.
+
+	if (_req.bodyBytesRead == _req.contentLength)
+		return (finishBody());
+	//	Otherwise, we need more body bytes.
+	return (false);
+}
+
+/*
+	writeBody(data, len)
 
-	if (_req.body.size() == _req.contentLength)
+	Hands body bytes to the sink chosen for this request.
+	The body limit is checked here, as bytes arrive: a chunked body has no
+	size announced in advance, and an upload must not be written past it.
+	Returns false (error state set) on 413 or if the sink failed.
+*/
+bool	HttpRequestParser::writeBody(const char *data, size_t len)
+{
+	// bodyBytesRead < _maxBodySize always holds here: no overflow
+	if (len >= _maxBodySize - _req.bodyBytesRead)
 	{
-		_state = PS_DONE;
-		return (true);
+		setError(413);
+		return (false);
 	}
-	//	Otherwise, we need more body bytes from feed().
-	return (false);
+	if (_sink->write(data, len) == false)
+	{
+		setError(500);
+		return (false);
+	}
+	_req.bodyBytesRead += len;
+	return (true);
+}
+
+bool	HttpRequestParser::finishBody()
+{
+	if (_sink->finish(_req) == false)
+		return (setError(500));
+	_state = PS_DONE;
+	return (true);
+}
+
+/*
+	Body sink selection (see RequestParser.hpp)
+*/
+
+void	HttpRequestParser::waitForBodySink(bool wait)
+{
+	_waitForSink = wait;
+}
+
+bool	HttpRequestParser::needsBodySink() const
+{
+	return (_state == PS_BODY && _sink == NULL);
+}
+
+void	HttpRequestParser::useSink(BodySink *sink, size_t maxBodySize)
+{
+	_sink = sink;
+	_maxBodySize = maxBodySize;
+}
+
+void	HttpRequestParser::keepBody(size_t maxBodySize)
+{
+	useSink(&_memorySink, maxBodySize);
+}
+
+void	HttpRequestParser::discardBody(size_t maxBodySize)
+{
+	useSink(&_discardSink, maxBodySize);
+}
+
+bool	HttpRequestParser::streamBodyToFile(const std::string &path, size_t maxBodySize)
+{
+	if (_fileSink.open(path) == false)
+		return (false);
+	useSink(&_fileSink, maxBodySize);
+	return (true);
+}
+
+void	HttpRequestParser::streamBodyTo(BodySink *sink, size_t maxBodySize)
+{
+	useSink((sink != NULL) ? sink : &_memorySink, maxBodySize);
+}
+
+// Sans effet si le body est complet (finish() deja appele) ou garde en memoire
+void	HttpRequestParser::abortBody()
+{
+	if (_sink != NULL)
+		_sink->abort();
 }
 
 
@@ -82,7 +161,7 @@ bool	HttpRequestParser::parseBody()
 		0\r\n
 		\r\n
 
-	We must decode the chunks and append the data into _req.body.
+	We must decode the chunks and hand the data to the body sink.
 */
 
 /*
@@ -96,45 +175,55 @@ bool	HttpRequestParser::parseBody()
 */
 bool	HttpRequestParser::parseChunkSizeLine()
 {
-	std::string			line;
-	bool				hasLine;
-	std::istringstream	iss;
+	ByteScan::Line		scan;
+	const char			*line;
+	size_t				start;
+	size_t				end;
 	size_t				sizeValue;
+	NumberParse::Result	res;
 
-	hasLine = false;
-	line = readLine(hasLine);
-
-	//	If we don't have a full line yet, wait for more data.
-	if (hasLine == false)
+	/*
+		If we don't have a full line yet, wait for more data: everything in
+		the input is that line. Size + extensions are capped like a header
+		line (_maxLine), or a client could make us buffer without end.
+	*/
+	if (nextLine(scan) == false)
+	{
+		if (_in->size() > 0 && _in->size() - 1 > _maxLine)
+			return (setError(400));
 		return (false);
+	}
+	if (scan.length > _maxLine)
+		return (setError(400));
 
 	/*
 		Chunk size is hex (base 16). Example: "4" or "1A".
 		There may be optional chunk extensions like: "4;ext=1"
-		We ignore extensions by cutting at ';' if present.
+		We ignore extensions by cutting at ';' if present, and spaces
+		around the size (read in place, the line is consumed after).
 	*/
+	line = _in->data();
+	end = scan.length;
 	{
-		std::string::size_type	pos;
-
-		pos = line.find(';');
-		if (pos != std::string::npos)
-			line = line.substr(0, pos);
+		const void	*semi = std::memchr(line, ';', end);
+		if (semi != NULL)
+			end = static_cast<const char *>(semi) - line;
 	}
-
-	line = trim(line);
-	if (line.empty() == true)
-		return (setError(400));
+	start = 0;
+	while (start < end && std::isspace(static_cast<unsigned char>(line[start])))
+		++start;
+	while (end > start && std::isspace(static_cast<unsigned char>(line[end - 1])))
+		--end;
 
 	/*
-		Parse hex number.
-		std::istringstream + std::hex lets us read hex into an integer.
+		Parse hex number (only hex digits: no sign, no "0x", no garbage).
+		A size that does not fit in size_t cannot be accepted anyway: 413.
 	*/
-	sizeValue = 0;
-	iss.clear();
-	iss.str(line);
-	iss >> std::hex >> sizeValue;
-
-	if (iss.fail())
+	res = NumberParse::hex(line + start, end - start, sizeValue);
+	consumeLine(scan);
+	if (res == NumberParse::NUM_OVERFLOW)
+		return (setError(413));
+	if (res != NumberParse::NUM_OK)
 		return (setError(400));
 
 	_req.chunkSize = sizeValue;
@@ -144,23 +233,36 @@ bool	HttpRequestParser::parseChunkSizeLine()
 }
 
 /*
-	consumeFinalChunkCRLF()
+	consumeTrailers()
 
-	After a 0-size chunk, we require the final "\r\n".
+	After a 0-size chunk: optional trailer fields, then the final "\r\n".
+	Trailer fields are read and ignored. They count against the same
+	limits as the head (_maxLine per line, _maxHeadSize in total with the
+	head): past them, 431.
 	Returns:
 		- false : need more data
-		- true  : consumed CRLF and marked done
+		- true  : final CRLF consumed and marked done (or error set)
 */
-bool	HttpRequestParser::consumeFinalChunkCRLF()
+bool	HttpRequestParser::consumeTrailers()
 {
-	if (_buffer.size() < 2)
-		return (false);
-	if (_buffer.substr(0, 2) != "\r\n")
-		return (setError(400));
-	_buffer.erase(0, 2);
+	ByteScan::Line	scan;
 
-	_state = PS_DONE;
-	return (true);
+	while (true)
+	{
+		if (nextLine(scan) == false)
+		{
+			if (_in->size() > 0 && (_in->size() - 1 > _maxLine
+					|| _headBytes + _in->size() > _maxHeadSize))
+				return (setError(431));
+			return (false);
+		}
+		if (scan.length > _maxLine || _headBytes + scan.length + 2 > _maxHeadSize)
+			return (setError(431));
+		consumeLine(scan);
+		if (scan.length == 0)
+			return (finishBody());
+		_headBytes += scan.length + 2;	// trailer field, ignored
+	}
 }
 
 /*
@@ -175,32 +277,35 @@ bool	HttpRequestParser::consumeFinalChunkCRLF()
 */
 bool	HttpRequestParser::consumeChunkDataAndCRLF()
 {
-	//STEP B: We know the chunk size. We must read exactly that many bytes from _buffer.
-
-	//Not enough data yet to read the full chunk.
-
-	if (_buffer.size() < _req.chunkSize)
-		return (false);
-
-	// if (_hasMaxBodySize == true)
-	// {
-	// 	if (_req.body.size() + _req.chunkSize > _maxBodySize)
-	// 		return (setError(413));
-	// }
+	/*
+		STEP B: Chunk data goes to the sink as it arrives: a big chunk is
+		not kept in the input until complete. _req.chunkSize counts the
+		bytes still expected, so data already passed on is never taken
+		a second time.
+	*/
+	if (_req.chunkSize > 0)
+	{
+		size_t	canTake;
 
-	//	Append chunk data to the decoded body.
-	_req.body.append(_buffer, 0, _req.chunkSize);
-	_buffer.erase(0, _req.chunkSize);
+		if (_in->size() == 0)
+			return (false);
+		canTake = (_in->size() < _req.chunkSize) ? _in->size() : _req.chunkSize;
+		if (writeBody(_in->data(), canTake) == false)
+			return (true);
+		_in->consume(canTake);
+		_req.chunkSize -= canTake;
+		if (_req.chunkSize > 0)
+			return (false);
+	}
 
 	//	STEP C: After chunk data, the protocol requires "\r\n".
-	if (_buffer.size() < 2)
+	if (_in->size() < 2)
 		return (false);
-	if (_buffer.substr(0, 2) != "\r\n")
+	if (std::memcmp(_in->data(), "\r\n", 2) != 0)
 		return (setError(400));
-	_buffer.erase(0, 2);
+	_in->consume(2);
 
 	//	Chunk finished. Next chunk size line must be parsed.
-	_req.chunkSize = 0;
 	_req.chunkSizeKnown = false;
 
 	return (true);
@@ -218,6 +323,10 @@ bool	HttpRequestParser::parseBodyChunked()
 {
 	while (true)
 	{
+		// Last chunk already read (the final CRLF may come in a later read)
+		if (_req.lastChunk)
+			return (consumeTrailers());
+
 		/*
 			STEP A: If we don't know the next chunk size, we must parse the size line.
 			The size line ends with "\r\n".
@@ -226,18 +335,24 @@ bool	HttpRequestParser::parseBodyChunked()
 		{
 			if (parseChunkSizeLine() == false)
 				return (false);
+			if (_state != PS_BODY)
+				return (true);	// malformed size line (error already set)
 
 			/*
 				If chunk size is 0, that means: end of body.
-				After 0\r\n there is a final "\r\n" (and optional trailer headers).
-				For this project step, we just require the final "\r\n".
+				After 0\r\n there are optional trailer fields, then a final "\r\n".
 			*/
 			if (_req.chunkSize == 0)
-				return (consumeFinalChunkCRLF());
+			{
+				_req.lastChunk = true;
+				return (consumeTrailers());
+			}
 		}
 
 		if (consumeChunkDataAndCRLF() == false)
 			return (false);
+		if (_state != PS_BODY)
+			return (true);		// bad CRLF, 413 or sink failure (error already set)
 
 		//	Loop again: parse next size line, read next chunk, etc.
 	}
@@ -247,13 +362,20 @@ void	HttpRequestParser::resetKeepBuffer()
 {
 	/*
 		Prepare to parse a NEW request,
-		but DO NOT clear _buffer.
+		but DO NOT clear the input buffer.
 
 		This is important when:
 		- we received 2 requests in the same socket read
 		- or we received extra bytes after finishing the body
 	*/
 	_state = PS_START_LINE;
+	abortBody();
 	_req = HttpRequest();
 	_errorStatus = 0;
+	_headBytes = 0;
+	_headerCount = 0;
+	_scanned = 0;
+	_line = ByteScan::Line();
+	_sink = NULL;
+	_maxBodySize = static_cast<size_t>(-1);
 }
@@ -29,7 +29,7 @@ bool	HttpRequestParser::hasBufferedData() const
 		Returns true if there are still unconsumed bytes in the internal buffer.
 		This is useful to know if another request might already be waiting.
 	*/
-	if (_buffer.empty() == true)
+	if (_in->empty() == true)
 		return (false);
 	return (true);
 }
@@ -50,26 +50,23 @@ bool	HttpRequestParser::shouldCloseConnection() const
 			- close by default
 			- keep alive only if "Connection: keep-alive"
 
-		We store header names in lowercase, so we check "connection".
-		We also lowercase the header value to compare safely.
+		"connection" has its own slot in the header table, and the value
+		is searched case-insensitively in place (no copy, no toLower).
 	*/
 
-	std::map<std::string, std::string>::const_iterator	it;
-	std::string											value;
+	HeaderView	value;
 
-	it = _req.headers.find("connection");
-	if (it != _req.headers.end())
+	value = _req.headers.get(HeaderTable::H_CONNECTION);
+	if (value.present())
 	{
-		value = toLower(trim(it->second));
-
 		/*
 			If there are multiple tokens like:
 				"keep-alive, upgrade"
 			we just check if "close" or "keep-alive" appears anywhere.
 		*/
-		if (value.find("close") != std::string::npos)
+		if (value.containsNoCase("close"))
 			return (true);
-		if (_req.httpVersion == "HTTP/1.0" && value.find("keep-alive") != std::string::npos)
+		if (_req.httpVersion == "HTTP/1.0" && value.containsNoCase("keep-alive"))
 			return (false);
 	}
 
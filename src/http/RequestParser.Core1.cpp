@@ -1,19 +1,7 @@
 #include "http/RequestParser.hpp"
 #include <cctype>
 #include "utils.hpp"
-
-/*
-	<sstream> is used for std::istringstream.
-	We use it to split the start line like this:
-
-		"GET /index.html HTTP/1.1"
-
-	into:
-		method = "GET"
-		target = "/index.html"
-		version = "HTTP/1.1"
-*/
-#include <sstream>
+#include "network/ObjectPool.hpp"
 
 /*
 	CONSTRUCTOR
@@ -27,9 +15,23 @@
 */
 HttpRequestParser::HttpRequestParser()
 	: _state(PS_START_LINE),   // We start by parsing the start line
-	  _buffer(""),             // No data received yet
+	  _own(),                  // No data received yet
+	  _in(&_own),              // Until bind(): parse what feed() appends
+	  _scanned(0),             // Nothing searched yet
+	  _line(),
 	  _req(),                  // Default-constructed HttpRequest
-	  _errorStatus(0)          // No error
+	  _errorStatus(0),         // No error
+	  _headBytes(0),
+	  _headerCount(0),
+	  _maxLine(DEFAULT_MAX_LINE),
+	  _maxHeadSize(DEFAULT_MAX_HEADER_SIZE),
+	  _maxHeaders(DEFAULT_MAX_HEADERS),
+	  _waitForSink(false),     // Standalone use: body kept in memory
+	  _sink(NULL),             // Chosen once the headers are parsed
+	  _maxBodySize(static_cast<size_t>(-1)),
+	  _memorySink(_req.body),
+	  _discardSink(),
+	  _fileSink()
 {
 	// Constructor body is empty because everything is initialized above
 }
@@ -43,10 +45,37 @@ HttpRequestParser::HttpRequestParser()
 */
 void HttpRequestParser::reset()
 {
+	abortBody();               // unfinished upload file is removed
 	_state = PS_START_LINE;
-	_buffer.clear();           // remove any leftover raw data
+	_in->clear();              // remove any leftover raw data
+	_scanned = 0;
+	_line = ByteScan::Line();
 	_req = HttpRequest();      // reset request to default values
 	_errorStatus = 0;
+	_headBytes = 0;
+	_headerCount = 0;
+	_sink = NULL;
+	_maxBodySize = static_cast<size_t>(-1);
+}
+
+/*
+	recycle(capacity_cap)
+
+	Called when the parser goes back to the Server's ObjectPool.
+	Same as reset() + bind(NULL), but the buffers keep their capacity for the next
+	client unless they grew beyond capacity_cap (a big upload).
+	Note: `_req = HttpRequest()` keeps the old body and header arena
+	capacity, so they are trimmed explicitly.
+*/
+void HttpRequestParser::recycle(size_t capacity_cap)
+{
+	_in = &_own;               // first: the Connection (and its buffer) may already be gone
+	reset();
+	_waitForSink = false;
+	setHeaderLimits(DEFAULT_MAX_LINE, DEFAULT_MAX_HEADER_SIZE, DEFAULT_MAX_HEADERS);
+	_own.recycle(capacity_cap);
+	recycleBuffer(_req.body, capacity_cap);
+	_req.headers.recycle(capacity_cap);
 }
 
 /*
@@ -61,13 +90,41 @@ void HttpRequestParser::reset()
 */
 void	HttpRequestParser::feed(const std::string &data)
 {
-	bool	progress;
 	// If parsing is already finished or failed, ignore new data
 	if (_state == PS_DONE || _state == PS_ERROR)
 		return ;
 
-	// Append new data to our internal buffer
-	_buffer.append(data);
+	// Append new data to our input buffer
+	_in->append(data.data(), data.size());
+	parse();
+}
+
+void	HttpRequestParser::setHeaderLimits(size_t maxLine, size_t maxTotal, size_t maxHeaders)
+{
+	_maxLine = maxLine;
+	_maxHeadSize = maxTotal;
+	_maxHeaders = maxHeaders;
+}
+
+void	HttpRequestParser::bind(RecvBuffer *input)
+{
+	_in = (input != NULL) ? input : &_own;
+	_scanned = 0;
+	_line = ByteScan::Line();
+}
+
+/*
+	parse()
+
+	Same as feed() without the copy: the network code already recv()'d
+	the bytes into the bound buffer.
+*/
+void	HttpRequestParser::parse()
+{
+	bool	progress;
+
+	if (_state == PS_DONE || _state == PS_ERROR)
+		return ;
 
 	/*
 		We try to parse as much as possible.
@@ -88,6 +145,19 @@ void	HttpRequestParser::feed(const std::string &data)
 		else
 			break ;
 	}
+
+	/*
+		Still in the head: everything left in the input belongs to a line
+		not finished yet (its last byte may be the '\r' of the CRLF).
+		Stop buffering as soon as that line or the head is too big.
+	*/
+	if (_state == PS_START_LINE || _state == PS_HEADERS)
+	{
+		if (_in->size() > 0 && _in->size() - 1 > _maxLine)
+			setError(_state == PS_START_LINE ? 400 : 431);
+		else if (_headBytes + _in->size() > _maxHeadSize)
+			setError(431);
+	}
 	// [DEBUG]
 	// std::cout << GOLD << _state << RES << std::endl;
 	// printHttpRequest(_req);
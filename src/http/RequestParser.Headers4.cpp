@@ -1,85 +1,66 @@
 #include "http/RequestParser.hpp"
 #include <cctype>
-#include <sstream>
 
-bool	HttpRequestParser::handleHeaderLine(const std::string &line)
+bool	HttpRequestParser::handleHeaderLine(const char *line, const ByteScan::Line &scan)
 {
-	std::string::size_type	pos;
-	std::string				name;
-	std::string				value;
+	size_t		nameStart;
+	size_t		nameEnd;
+	size_t		valueStart;
+	size_t		valueEnd;
 
 	/*
 		Normal header line case:
 			Name: value
 
 		Must contain ':' or the request is malformed.
+		(The scan already found the first ':' of the line.)
 	*/
-	pos = line.find(':');
-	if (pos == std::string::npos)
+	if (scan.colon == ByteScan::npos)
 		return (setError(400));
 
 	/*
-		Split the header into name and value.
+		Split the header into name and value, trimming spaces around both
+		directly on the input bytes (no intermediate copies).
 	*/
-	name = line.substr(0, pos);
-	value = line.substr(pos + 1);
+	nameStart = 0;
+	nameEnd = scan.colon;
+	while (nameStart < nameEnd && std::isspace(static_cast<unsigned char>(line[nameStart])))
+		++nameStart;
+	while (nameEnd > nameStart && std::isspace(static_cast<unsigned char>(line[nameEnd - 1])))
+		--nameEnd;
+	valueStart = scan.colon + 1;
+	valueEnd = scan.length;
+	while (valueStart < valueEnd && std::isspace(static_cast<unsigned char>(line[valueStart])))
+		++valueStart;
+	while (valueEnd > valueStart && std::isspace(static_cast<unsigned char>(line[valueEnd - 1])))
+		--valueEnd;
 
-	/*
-		Normalize:
-		- Header names are case-insensitive. We store them in lowercase.
-		- Trim spaces around name and value.
-	*/
-	name = toLower(trim(name));
-	value = trim(value);
-
-	if (name.empty() == true)
+	if (nameEnd == nameStart)
 		return (setError(400));
 
 	/*
-		Store header in the request map.
-		If the same header appears multiple times, this overwrites.
+		Store header in the request table (the name is lowercased there:
+		header names are case-insensitive).
+		If the same header appears multiple times, the last one wins.
 	*/
-	_req.headers[name] = value;
+	_req.headers.add(line + nameStart, nameEnd - nameStart,
+					 line + valueStart, valueEnd - valueStart);
 
 	return (true);
 }
 
-bool	HttpRequestParser::parseContentLengthValue(size_t &outValue, const std::string &value)
+NumberParse::Result	HttpRequestParser::parseContentLengthValue(size_t &outValue, const HeaderView &value)
 {
-	std::string			s;
-	std::istringstream	iss;
-	char				extra;
-
 	/*
 		We want Content-Length to be ONLY digits (no extra text).
 		Examples:
 			"5"     -> OK
-			"  5 "  -> OK (after trim)
-			"5abc"  -> ERROR
-			""      -> ERROR
-	*/
-	s = trim(value);
-	if (s.empty() == true)
-		return (false);
-
-	outValue = 0;
-	iss.clear();
-	iss.str(s);
-
-	/*
-		Read a number into outValue.
+			"  5 "  -> OK (already trimmed by handleHeaderLine)
+			"5abc"  -> NUM_INVALID
+			""      -> NUM_INVALID
+			"99999999999999999999999" -> NUM_OVERFLOW (does not fit in size_t)
 	*/
-	if (!(iss >> outValue))
-		return (false);
-
-	/*
-		If there is anything left after the number, reject it.
-		This rejects "5abc".
-	*/
-	if (iss >> extra)
-		return (false);
-
-	return (true);
+	return (NumberParse::decimal(value.data, value.size, outValue));
 }
 
 bool	HttpRequestParser::finalizeHeaders()
@@ -102,7 +83,7 @@ bool	HttpRequestParser::finalizeHeaders()
 	*/
 	if (_req.httpVersion == "HTTP/1.1")
 	{
-		if (_req.headers.find("host") == _req.headers.end())
+		if (_req.headers.has(HeaderTable::H_HOST) == false)
 			return (setError(400));
 	}
 
@@ -118,12 +99,9 @@ bool	HttpRequestParser::finalizeHeaders()
 		- If Transfer-Encoding exists and includes "chunked", we mark chunked.
 		- If Transfer-Encoding exists but is NOT chunked, return 501 (unsupported).
 	*/
-	if (_req.headers.find("transfer-encoding") != _req.headers.end())
+	if (_req.headers.has(HeaderTable::H_TRANSFER_ENCODING))
 	{
-		std::string	te;
-
-		te = toLower(trim(_req.headers["transfer-encoding"]));
-		if (te.find("chunked") != std::string::npos)
+		if (_req.headers.get(HeaderTable::H_TRANSFER_ENCODING).containsNoCase("chunked"))
 			_req.chunked = true;
 		else
 			return (setError(501));
@@ -132,11 +110,19 @@ bool	HttpRequestParser::finalizeHeaders()
 	/*
 		RULE 4: Content-Length handling (strict parsing)
 	*/
-	if (_req.headers.find("content-length") != _req.headers.end())
+	if (_req.headers.has(HeaderTable::H_CONTENT_LENGTH))
 	{
-		size_t	value;
-
-		if (parseContentLengthValue(value, _req.headers["content-length"]) == false)
+		size_t				value;
+		NumberParse::Result	res;
+
+		/*
+			Garbage -> 400. A length too big to even be represented can
+			only exceed any body limit -> 413.
+		*/
+		res = parseContentLengthValue(value, _req.headers.get(HeaderTable::H_CONTENT_LENGTH));
+		if (res == NumberParse::NUM_OVERFLOW)
+			return (setError(413));
+		if (res != NumberParse::NUM_OK)
 			return (setError(400));
 		_req.hasContentLength = true;
 		_req.contentLength = value;
@@ -151,21 +137,35 @@ bool	HttpRequestParser::finalizeHeaders()
 	if (_req.chunked == true && _req.hasContentLength == true)
 		return (setError(400));
 
-	// Size rule: if Content-Length exists, we can reject immediately
-	// if (_req.hasContentLength == true && _hasMaxBodySize == true)
-	// {
-	// 	if (_req.contentLength > _maxBodySize)
-	// 		return (setError(413));
-	// }
+	/*
+		RULE 6: Expect
+		- "100-continue": the client waits for an interim "100 Continue"
+		  before sending the body. The Server sends it once it knows the
+		  body is wanted (see Server::selectBodySink()).
+		- Any other expectation -> 417 (we support none).
+		HTTP/1.0 clients do not know 1xx responses: the header is ignored.
+	*/
+	_req.expectContinue = false;
+	if (_req.httpVersion != "HTTP/1.0" && _req.headers.has(HeaderTable::H_EXPECT))
+	{
+		if (_req.headers.get(HeaderTable::H_EXPECT).equals("100-continue") == false)
+			return (setError(417));
+		_req.expectContinue = true;
+	}
 
 	/*
 		Decide next state:
-		- If chunked or content-length -> parse body
+		- If chunked or content-length (not 0) -> parse body. The Server
+		  may want to choose where it goes first (waitForBodySink()),
+		  otherwise it is kept in memory.
 		- Else -> done
 	*/
-	if (_req.chunked == true || _req.hasContentLength == true)
+	if (_req.chunked == true
+		|| (_req.hasContentLength == true && _req.contentLength > 0))
 	{
 		_state = PS_BODY;
+		if (_waitForSink == false)
+			keepBody(static_cast<size_t>(-1));
 		return (true);
 	}
 
@@ -176,29 +176,46 @@ bool	HttpRequestParser::finalizeHeaders()
 
 bool	HttpRequestParser::parseHeaders()
 {
-	bool		hasLine;
-	std::string	line;
-
-	hasLine = false;
-	line = readLine(hasLine);
+	ByteScan::Line	scan;
+	bool			progress;
 
 	/*
-		If we do not have a complete line yet (no "\r\n" in _buffer),
+		If we do not have a complete line yet (no "\r\n" in the input),
 		then we cannot continue and must wait for more data.
 	*/
-	if (hasLine == false)
+	if (nextLine(scan) == false)
 		return (false);
 
+	/*
+		Head limits, per request (see setHeaderLimits(); parse() checks
+		the line not finished yet):
+		- one header line
+		- whole head (start line + headers)
+		- number of header lines
+	*/
+	if (scan.length > _maxLine)
+		return (setError(431));
+	if (_headBytes + scan.length + 2 > _maxHeadSize)
+		return (setError(431));
+	if (scan.length > 0 && ++_headerCount > _maxHeaders)
+		return (setError(431));
+
 	/*
 		An empty line means: end of headers.
 		This is the separator between headers and the optional body:
 			\r\n\r\n
 	*/
-	if (line.empty() == true)
+	if (scan.length == 0)
+	{
+		consumeLine(scan);
 		return (finalizeHeaders());
+	}
 
 	/*
 		Otherwise, this is a normal header line: "Name: value"
+		(parsed in place, then consumed)
 	*/
-	return (handleHeaderLine(line));
+	progress = handleHeaderLine(_in->data(), scan);
+	consumeLine(scan);
+	return (progress);
 }
@@ -1,6 +1,5 @@
 #include "http/RequestParser.hpp"
 #include <cctype>
-#include <sstream>
 #include <iostream>
 #include "colours.hpp"
 
@@ -9,9 +8,12 @@
 
 	Called when the request is malformed.
 	Sets the parser to PS_ERROR and stores the HTTP error code.
+	An error in the middle of the body drops the upload right away: the
+	parser is only reset when the connection is closed.
 */
 bool	HttpRequestParser::setError(int statusCode)
 {
+	abortBody();
 	_state = PS_ERROR;
 	_errorStatus = statusCode;
 	return (true);
@@ -29,9 +31,8 @@ bool	HttpRequestParser::setError(int statusCode)
 */
 bool	HttpRequestParser::parseStartLine()
 {
-	bool				hasLine;
-	std::string			line;
-	std::istringstream	iss;
+	ByteScan::Line		scan;
+	const char			*line;
 	std::string			methodStr;
 	std::string			target;
 	std::string			version;
@@ -41,29 +42,34 @@ bool	HttpRequestParser::parseStartLine()
 
 			"GET /path HTTP/1.1\r\n"
 
-		If we don't have "\r\n" yet, readLine() will fail and we must wait.
+		If we don't have "\r\n" yet, nextLine() will fail and we must wait.
 	*/
-	hasLine = false;
-	line = readLine(hasLine);
-	if (hasLine == false)
+	if (nextLine(scan) == false)
 		return (false);
 
 	/*
-		Safety limit: avoid extremely long start lines.
-		(Exact limits can be adjusted later.)
+		Safety limit: avoid extremely long start lines
+		(large_client_header_buffers, see setHeaderLimits()).
 	*/
-	if (line.size() > 8192)
+	if (scan.length > _maxLine)
 		return (setError(400));
 
 	/*
-		Split the start line by spaces using istringstream:
+		Split the start line on the two spaces found by the scan:
 
-			METHOD TARGET VERSION
-	*/
-	iss.clear();
-	iss.str(line);
+			METHOD SP TARGET SP VERSION
 
-	if (!(iss >> methodStr >> target >> version))
+		Exactly one space between the 3 parts (RFC 9112): an empty part
+		(double space) or a space inside VERSION is malformed.
+	*/
+	line = _in->data();
+	if (scan.space1 == ByteScan::npos || scan.space2 == ByteScan::npos)
+		return (setError(400));
+	methodStr.assign(line, scan.space1);
+	target.assign(line + scan.space1 + 1, scan.space2 - scan.space1 - 1);
+	version.assign(line + scan.space2 + 1, scan.length - scan.space2 - 1);
+	consumeLine(scan);
+	if (methodStr.empty() || target.empty())
 		return (setError(400));
 
 	/*
@@ -1,80 +1,39 @@
 #include "http/RequestParser.hpp"
-#include <cctype>
 
 /*
-	readLine(hasLine)
+	nextLine(line)
 
-	This function tries to read ONE line ending in "\r\n" from _buffer.
+	Scans the input for ONE line ending in "\r\n" (see ByteScan).
 
 	Example:
-		_buffer = "GET / HTTP/1.1\r\nHost: a\r\n"
+		input = "GET / HTTP/1.1\r\nHost: a\r\n"
 
 	First call:
-		returns "GET / HTTP/1.1"
-		_buffer becomes "Host: a\r\n"
+		line.length = 14, line.space1 = 3, line.space2 = 5
+		input is unchanged until consumeLine(line): "Host: a\r\n"
 */
-std::string HttpRequestParser::readLine(bool &hasLine)
+bool	HttpRequestParser::nextLine(ByteScan::Line &line)
 {
-	hasLine = false;
-
-	// Look for CRLF sequence
-	std::string::size_type pos = _buffer.find("\r\n");
-	if (pos == std::string::npos)
+	// Resume after what previous calls already scanned
+	if (ByteScan::scanLine(_in->data(), _in->size(), _scanned, _line) == false)
 	{
-		// No full line yet
-		return ("");
+		// No full line yet: next time, start at the last byte
+		// (it may be the '\r' of a CRLF split between two reads)
+		_scanned = (_in->size() > 0) ? _in->size() - 1 : 0;
+		return (false);
 	}
-
-	// Extract the line WITHOUT the "\r\n"
-	std::string line = _buffer.substr(0, pos);
-
-	// Remove the line + "\r\n" from buffer
-	_buffer.erase(0, pos + 2);
-
-	hasLine = true;
-	return (line);
-}
-
-/*
-	trim(s)
-
-	Removes whitespace from the beginning and end of a string.
-	Used for header names and values.
-
-	Example:
-		"  Host  " -> "Host"
-*/
-std::string HttpRequestParser::trim(const std::string &s)
-{
-	std::string::size_type start = 0;
-	while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start])))
-		++start;
-
-	std::string::size_type end = s.size();
-	while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1])))
-		--end;
-
-	return (s.substr(start, end - start));
+	line = _line;
+	_line = ByteScan::Line();
+	_scanned = 0;
+	return (true);
 }
 
-/*
-	toLower(s)
-
-	Converts a string to lowercase.
-	HTTP header names are case-insensitive, so we normalize them.
-
-	Example:
-		"Host" -> "host"
-*/
-std::string HttpRequestParser::toLower(const std::string &s)
+// Consume the line + "\r\n" (only moves the read offset)
+void	HttpRequestParser::consumeLine(const ByteScan::Line &line)
 {
-	std::string out = s;
-	for (std::string::size_type i = 0; i < out.size(); ++i)
-	{
-		out[i] = static_cast<char>(
-			std::tolower(static_cast<unsigned char>(out[i])));
-	}
-	return (out);
+	if (_state == PS_START_LINE || _state == PS_HEADERS)
+		_headBytes += line.length + 2;
+	_in->consume(line.length + 2);
 }
 
 /*
@@ -1,112 +1,250 @@
 #include "http/ResponseBuilder.hpp"
-#include <sstream>
-#include <ctime>
+#include "network/Clock.hpp"
+#include <cstring>
+#include <strings.h>
+
+const char	*const ResponseBuilder::continueResponse = "HTTP/1.1 100 Continue" CRLF CRLF;
 
 /*
-	toStringSize(n)
+	Status lines and fixed headers, written as-is (no formatting).
+	Same codes and reason phrases as Status.hpp: a response with another
+	code or a custom reason gets its status line built by hand.
+*/
+struct StatusLine
+{
+	int			code;
+	const char	*line;
+};
+
+static const StatusLine	g_statusLines[] = {
+	{200, "HTTP/1.1 200 OK" CRLF},
+	{201, "HTTP/1.1 201 Created" CRLF},
+	{204, "HTTP/1.1 204 No Content" CRLF},
+	{301, "HTTP/1.1 301 Moved Permanently" CRLF},
+	{302, "HTTP/1.1 302 Found" CRLF},
+	{304, "HTTP/1.1 304 Not Modified" CRLF},
+	{400, "HTTP/1.1 400 Bad Request" CRLF},
+	{403, "HTTP/1.1 403 Forbidden" CRLF},
+	{404, "HTTP/1.1 404 Not Found" CRLF},
+	{405, "HTTP/1.1 405 Method Not Allowed" CRLF},
+	{413, "HTTP/1.1 413 Payload Too Large" CRLF},
+	{417, "HTTP/1.1 417 Expectation Failed" CRLF},
+	{431, "HTTP/1.1 431 Request Header Fields Too Large" CRLF},
+	{500, "HTTP/1.1 500 Internal Server Error" CRLF},
+	{501, "HTTP/1.1 501 Not Implemented" CRLF},
+	{502, "HTTP/1.1 502 Bad Gateway" CRLF},
+	{503, "HTTP/1.1 503 Service Unavailable" CRLF},
+	{504, "HTTP/1.1 504 Gateway Timeout" CRLF}
+};
+
+// sizeof(literal) - 1 = length without the final '\0'
+#define LIT(s)	s, sizeof(s) - 1
+
+static const char	g_statusPrefix[] = "HTTP/1.1 ";		// + "200 "
+static const char	g_connClose[] = "Connection: close" CRLF;
+static const char	g_connKeepAlive[] = "Connection: keep-alive" CRLF;
+static const char	g_server[] = "Server: webserv" CRLF;
+static const char	g_date[] = "Date: ";
+static const char	g_contentLength[] = "Content-Length: ";
 
-	C++98 does not have std::to_string.
-	We use stringstream instead.
+/*
+	Precomputed status line for resp, NULL when the code is not in the
+	table or the reason is not the standard one.
 */
-std::string	ResponseBuilder::toStringSize(size_t n)
+static const char	*findStatusLine(const HttpResponse &resp, size_t &len)
 {
-	std::ostringstream	oss;
+	for (size_t i = 0; i < sizeof(g_statusLines) / sizeof(g_statusLines[0]); ++i)
+	{
+		if (g_statusLines[i].code != resp.statusCode)
+			continue ;
+		const char	*line = g_statusLines[i].line;
+		len = std::strlen(line);
+		// "HTTP/1.1 200 " = 13 bytes, then reason + CRLF
+		if (resp.reason.size() == len - 15
+			&& resp.reason.compare(0, resp.reason.size(), line + 13, len - 15) == 0)
+			return (line);
+		return (NULL);
+	}
+	return (NULL);
+}
 
-	oss << n;
-	return (oss.str());
+// Headers the builder writes itself (a CGI may send its own)
+static bool	isOwnedHeader(const std::string &name)
+{
+	return (strcasecmp(name.c_str(), "Content-Length") == 0
+		|| strcasecmp(name.c_str(), "Date") == 0
+		|| strcasecmp(name.c_str(), "Server") == 0
+		|| strcasecmp(name.c_str(), "Connection") == 0);
 }
 
 /*
-	buildDateValue()
-
-	Build a Date header value.
-	We use GMT (UTC) time because HTTP Date uses GMT.
+	writeSize(end, n)
 
-	Format example:
-		Sun, 21 Dec 2025 09:00:00 GMT
+	Writes n in decimal in the bytes just before end (no stringstream,
+	no allocation). Returns the position of the first digit.
 */
-std::string	ResponseBuilder::buildDateValue()
+char	*ResponseBuilder::writeSize(char *end, size_t n)
 {
-	std::time_t		now;
-	std::tm			*gmt;
-	char			buf[128];
-
-	now = std::time(NULL);
-	gmt = std::gmtime(&now);
+	do
+	{
+		*--end = static_cast<char>('0' + n % 10);
+		n /= 10;
+	} while (n != 0);
+	return (end);
+}
 
-	/*
-		strftime format:
-		%a = weekday short name
-		%d = day (01-31)
-		%b = month short name
-		%Y = year
-		%H:%M:%S = time
-	*/
-	if (gmt == NULL)
-		return ("");
-	std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", gmt);
-	return (std::string(buf));
+/*
+	304: no body and no Content-Length (it would have to be the one of the
+	200 it replaces, RFC 9110 8.6: simpler to leave it out, as nginx does)
+*/
+static bool	hasContentLength(const HttpResponse &resp)
+{
+	return (resp.statusCode != 304);
 }
 
 /*
-	build(resp, closeConnection)
+	Size and bytes of the part of a response that does not change from
+	one request to the next: Server, Content-Length, the headers of resp,
+	blank line, body (nothing for a file body, resp.bodyFd).
+*/
+static size_t	tailSize(const HttpResponse &resp, size_t sizeLen)
+{
+	size_t	total = sizeof(g_server) - 1;
 
-	This returns the full HTTP response message:
+	if (hasContentLength(resp))
+		total += sizeof(g_contentLength) - 1 + sizeLen + 2;
+	for (StringMap::const_iterator it = resp.headers.begin(); it != resp.headers.end(); ++it)
+		total += it->first.size() + 2 + it->second.size() + 2;
+	return (total + 2 + resp.body.size());
+}
 
-	- Status line
-	- Headers
-	- Blank line
-	- Body
-*/
+static void	appendTail(std::string &out, const HttpResponse &resp, const char *size, size_t sizeLen)
+{
+	out.append(LIT(g_server));
+	if (hasContentLength(resp))
+	{
+		out.append(LIT(g_contentLength));
+		out.append(size, sizeLen);
+		out.append(CRLF, 2);
+	}
+
+	// Headers defined during routing
+	for (StringMap::const_iterator it = resp.headers.begin(); it != resp.headers.end(); ++it)
+	{
+		if (isOwnedHeader(it->first))
+			continue ;
+		out += it->first;
+		out.append(": ", 2);
+		out += it->second;
+		out.append(CRLF, 2);
+	}
+	out.append(CRLF, 2); // mark end of headers
+
+	// Body (empty for a file body)
+	out += resp.body;
+}
 
 /**
- * @brief 	build(resp, closeConnection)
+ * @brief 	build(out, resp, closeConnection)
 
-	This returns the full HTTP response message:
+	Writes the full HTTP response message in out (the Connection's
+	send_buffer):
 
 	- Status line
-	- Headers
+	- Connection, Date
+	- Server, Content-Length, other headers
 	- Blank line
-	- Body
-	@attention Recurring Headers such as Date, content-length, etc.
-	are built in HttpResponse constructors
+	- Body (in memory; a file body, resp.bodyFd, is not copied here)
+
+	out is cleared but keeps its capacity, and its final size is reserved
+	once: a connection that already sent a response of this size does not
+	allocate. Status lines and fixed headers are copied from constant
+	strings, numbers are written by hand, Date comes from Clock.
+	A prebuilt response (file cache) stops after Date: the rest is
+	resp.prebuilt, sent as is by the Connection.
+	@attention Recurring Headers such as Date, Server and Content-Length
+	are always written here (they must match the final body): the same
+	names in resp.headers are ignored
  */
-std::string	ResponseBuilder::build(const HttpResponse &resp, bool closeConnection)
+void	ResponseBuilder::build(std::string &out, const HttpResponse &resp, bool closeConnection)
 {
-	std::stringstream	ss;
+	// File body (bodyFd): only the headers are written here, the
+	// Connection sends the file after them with sendfile()
+	size_t		bodySize = (resp.bodyFd >= 0) ? resp.bodyLength : resp.body.size();
+	char		sizeBuf[20];
+	char		*sizeStart = writeSize(sizeBuf + sizeof(sizeBuf), bodySize);
+	size_t		sizeLen = sizeBuf + sizeof(sizeBuf) - sizeStart;
+	const char	*date = Clock::httpDate();	// formatted once per second
+	size_t		dateLen = std::strlen(date);
+	size_t		statusLen = 0;
+	const char	*status = findStatusLine(resp, statusLen);
+	bool		prebuilt = !resp.prebuilt.empty();
+
+	/*
+		0) Final size, reserved once
+	*/
+	size_t	total = (status != NULL) ? statusLen
+		: sizeof(g_statusPrefix) - 1 + 4 + resp.reason.size() + 2;
+	total += closeConnection ? sizeof(g_connClose) - 1 : sizeof(g_connKeepAlive) - 1;
+	total += sizeof(g_date) - 1 + dateLen + 2;
+	if (!prebuilt)
+		total += tailSize(resp, sizeLen);
+
+	out.clear();
+	out.reserve(total);
 
 	/*
 		1) Status line
 		We always respond using HTTP/1.1 for simplicity.
 	*/
-	ss	<< "HTTP/1.1 "
-		<< toStringSize(resp.statusCode) << " "
-		<< resp.reason << CRLF;
+	if (status != NULL)
+		out.append(status, statusLen);
+	else
+	{
+		char	codeBuf[20];
+		char	*code = writeSize(codeBuf + sizeof(codeBuf), static_cast<size_t>(resp.statusCode));
+
+		out.append(LIT(g_statusPrefix));
+		out.append(code, codeBuf + sizeof(codeBuf) - code);
+		out += ' ';
+		out += resp.reason;
+		out.append(CRLF, 2);
+	}
 
 	/*
-		2) handle unique Connection Header
+		2) Connection, Date: the only headers that change per response
 	*/
 	if (closeConnection)
-		ss << "Connection: close" << CRLF;
+		out.append(LIT(g_connClose));
 	else
-		ss << "Connection: keep-alive" << CRLF;
+		out.append(LIT(g_connKeepAlive));
+	out.append(LIT(g_date));
+	out.append(date, dateLen);
+	out.append(CRLF, 2);
 
 	/*
-		3) insert other headers defined during routing
+		3) Server, Content-Length, headers defined during routing, body
 	*/
-	StringMap	h = resp.headers;
-	// Always compute recurring headers here so they match the final body
-	h["Date"] = buildDateValue();
-	h["Server"] = "webserv";
-	h["Content-Length"] = toStringSize(resp.body.size());
+	if (!prebuilt)
+		appendTail(out, resp, sizeStart, sizeLen);
+}
 
-	for (StringMap::const_iterator it = h.begin(); it != h.end(); ++it)
-		ss << it->first << ": " << it->second << CRLF;
-	ss << CRLF; // mark end of headers
+void	ResponseBuilder::buildPrebuilt(std::string &out, const HttpResponse &resp)
+{
+	size_t	bodySize = (resp.bodyFd >= 0) ? resp.bodyLength : resp.body.size();
+	char	sizeBuf[20];
+	char	*sizeStart = writeSize(sizeBuf + sizeof(sizeBuf), bodySize);
+	size_t	sizeLen = sizeBuf + sizeof(sizeBuf) - sizeStart;
+
+	out.clear();
+	out.reserve(tailSize(resp, sizeLen) + ((resp.bodyFd >= 0) ? resp.bodyLength : 0));
+	appendTail(out, resp, sizeStart, sizeLen);
+}
 
-	/*
-		4) insert body
-	*/
-	ss << resp.body;
-	return (ss.str());
+std::string	ResponseBuilder::build(const HttpResponse &resp, bool closeConnection)
+{
+	std::string	out;
+
+	build(out, resp, closeConnection);
+	return (out);
 }
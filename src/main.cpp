@@ -36,6 +36,8 @@ Notes:
 
 
 #include "../include/network/Server.hpp"
+#include "../include/network/ReactorPool.hpp"
+#include "../include/network/MasterProcess.hpp"
 #include "configParser/Config.hpp"
 #include "utils.hpp"
 #include <iostream>
@@ -90,6 +92,22 @@ int main(int argc, char** argv)
 		signal(SIGINT, signal_handler);
 		signal(SIGPIPE, SIG_IGN);  // Ignorer SIGPIPE
 
+		// worker_processes N: master (bind + supervision) + N workers forkes
+		if (cfg.workerProcesses > 0)
+		{
+			MasterProcess master(cfg);
+			master.run();
+			return (0);
+		}
+
+		// worker_threads N: un reactor (Server) par thread, SO_REUSEPORT
+		if (cfg.workerThreads > 1)
+		{
+			ReactorPool pool(cfg);
+			pool.run();
+			return (0);
+		}
+
 		// Creer et lancer le serveur multi-ports
 		Server server(cfg); // Passe toute la config (supporte multi-ports)
 		g_server = &server;
@@ -0,0 +1,83 @@
+#include "network/Clock.hpp"
+#include <cstring>
+
+// Une copie par thread (reactors de worker_threads): pas de verrou
+static __thread unsigned long long	t_now_ms = 0;
+static __thread time_t				t_now = 0;
+static __thread time_t				t_date_second = 0;	// seconde de t_date
+static __thread char				t_date[Clock::HTTP_DATE_LEN + 1];
+
+void Clock::update()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	t_now_ms = static_cast<unsigned long long>(ts.tv_sec) * 1000ULL + ts.tv_nsec / 1000000;
+	t_now = time(NULL);
+
+	// La Date ne change qu'une fois par seconde: strftime() au plus une fois par seconde
+	if (t_now != t_date_second)
+	{
+		if (formatHttpDate(t_now, t_date))
+			t_date_second = t_now;
+	}
+}
+
+unsigned long long Clock::now_ms()
+{
+	if (t_now == 0)
+		update();
+	return (t_now_ms);
+}
+
+time_t Clock::now()
+{
+	if (t_now == 0)
+		update();
+	return (t_now);
+}
+
+const char* Clock::httpDate()
+{
+	if (t_now == 0)
+		update();
+	return (t_date);
+}
+
+bool Clock::formatHttpDate(time_t t, char out[HTTP_DATE_LEN + 1])
+{
+	struct tm tmv;
+
+	// gmtime() partage un buffer statique entre threads
+	return (gmtime_r(&t, &tmv) != NULL
+		&& strftime(out, HTTP_DATE_LEN + 1, "%a, %d %b %Y %H:%M:%S GMT", &tmv) != 0);
+}
+
+bool Clock::parseHttpDate(const char* s, size_t len, time_t& t)
+{
+	// IMF-fixdate d'abord (le seul que les clients envoient encore)
+	static const char* const	formats[] = {
+		"%a, %d %b %Y %H:%M:%S GMT",
+		"%A, %d-%b-%y %H:%M:%S GMT",
+		"%a %b %e %H:%M:%S %Y"
+	};
+	char	buf[64];
+
+	if (len == 0 || len >= sizeof(buf))
+		return (false);
+	std::memcpy(buf, s, len);	// la valeur du header n'est pas terminee par '\0'
+	buf[len] = '\0';
+	for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+	{
+		struct tm	tmv;
+
+		std::memset(&tmv, 0, sizeof(tmv));
+		const char*	end = strptime(buf, formats[i], &tmv);
+		if (end != NULL && *end == '\0')
+		{
+			t = timegm(&tmv);
+			return (t != static_cast<time_t>(-1));
+		}
+	}
+	return (false);
+}
@@ -1,122 +1,346 @@
 #include "../../include/network/Connection.hpp"
+#include "../../include/network/ObjectPool.hpp"
+#include "../../include/network/Clock.hpp"
 #include <unistd.h>
-#include <fcntl.h>
 #include <cerrno>
 #include <cstring>
 #include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
 
 Connection::ConnectionException::ConnectionException(const std::string& message)
 	: std::runtime_error(message)
 {}
-// Constructeur: met automatiquement le fd en mode non-bloquant
+Connection::Connection()
+	:	fd(-1),
+		recv_buffer(),
+		send_buffer(),
+		bytes_sent(0),
+		file_fd(-1),
+		file_offset(0),
+		file_remaining(0),
+		prebuilt(),
+		prebuilt_sent(0),
+		last_activity(0),
+		should_close(false),
+		peer_closed(false),
+		drain_capped(false),
+		send_in_flight(false),
+		idle_timer(),
+		timers(NULL),
+		idle_timeout_ms(0)
+{
+	idle_timer.kind = TimerWheel::TIMER_CLIENT_IDLE;
+}
+
+// Constructeur: le fd doit deja etre non-bloquant (accept4 SOCK_NONBLOCK)
 Connection::Connection(int fd)
 	:	fd(fd),
-		totalBytesReceived(0),
 		recv_buffer(),
 		send_buffer(),
 		bytes_sent(0),
-		last_activity(time(NULL)),
-		should_close(false)
+		file_fd(-1),
+		file_offset(0),
+		file_remaining(0),
+		prebuilt(),
+		prebuilt_sent(0),
+		last_activity(Clock::now()),
+		should_close(false),
+		peer_closed(false),
+		drain_capped(false),
+		send_in_flight(false),
+		idle_timer(),
+		timers(NULL),
+		idle_timeout_ms(0)
 {
-	set_nonblocking();
+	idle_timer.kind = TimerWheel::TIMER_CLIENT_IDLE;
+	idle_timer.fd = fd;
 }
 
-// Met à jour le timestamp d'activité
+// Met à jour le timestamp d'activité et repousse le timeout d'inactivite (O(1))
 void Connection::update_activity()
 {
-	last_activity = time(NULL);
+	last_activity = Clock::now();
+	if (timers)
+		timers->schedule(idle_timer, idle_timeout_ms);
 }
 
-// Destructeur: ferme le fd
-Connection::~Connection()
+// Rattache la connexion a la TimerWheel du Server et arme le premier timeout
+void Connection::arm_idle_timeout(TimerWheel* wheel, unsigned long long timeout_ms)
+{
+	timers = wheel;
+	idle_timeout_ms = timeout_ms;
+	update_activity();
+}
+
+// Connexion sortie du pool (etat de recycle()): le fd doit etre non-bloquant
+void Connection::attach(int client_fd)
 {
+	fd = client_fd;
+	idle_timer.fd = client_fd;
+	last_activity = Clock::now();
+}
+
+// Retour au pool: comme le destructeur, mais les buffers gardent leur capacite
+void Connection::recycle(size_t capacity_cap)
+{
+	if (timers)
+		timers->cancel(idle_timer);
 	if (fd >= 0)
-	{
 		close(fd);
-	}
+	fd = -1;
+	idle_timer.fd = -1;
+	timers = NULL;
+	idle_timeout_ms = 0;
+	recv_buffer.recycle(capacity_cap);
+	recycleBuffer(send_buffer, capacity_cap);
+	bytes_sent = 0;
+	release_body();
+	last_activity = 0;
+	should_close = false;
+	peer_closed = false;
+	drain_capped = false;
+	send_in_flight = false;
 }
 
-// Met le socket en mode non-bloquant
-void Connection::set_nonblocking()
+// Destructeur: ferme le fd
+Connection::~Connection()
 {
-	// Note: subject only allows F_SETFL, O_NONBLOCK, FD_CLOEXEC (no F_GETFL)
-	if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0)
+	if (timers)
+		timers->cancel(idle_timer);
+	release_body();
+	if (fd >= 0)
 	{
-		throw ConnectionException("fcntl(F_SETFL, O_NONBLOCK) failed: " + std::string(strerror(errno)));
+		close(fd);
 	}
 }
+
 #include "utils.hpp"
 #include "http/ResponseBuilder.hpp"
 /**
- * @brief Lit toutes les donnees disponibles dans recv_buffer
+ * @brief Lit toutes les donnees disponibles directement dans recv_buffer
+ * (pas de buffer intermediaire: le parser consomme ces bytes en place)
+ * @param drain true en mode edge-triggered: on relit tant que recv() remplit
+ * tout le buffer, car epoll ne previendra plus tant que de nouvelles donnees
+ * n'arrivent pas. Un recv() partiel (ou -1 apres avoir deja lu) = socket vide.
+ * Le drain s'arrete aussi apres RECV_DRAIN_MAX bytes (drain_capped): le body
+ * n'est plus plafonne, le parser doit pouvoir vider recv_buffer entre deux drains.
  * @return >0 bytes lus, 0 si connexion fermee, -1 si erreur
  */
-ssize_t Connection::read_available()
+ssize_t Connection::read_available(bool drain)
 {
-	size_t	bufferSize = 4096;
-	char	buffer[bufferSize];
-
-	// Un seul appel recv() par evenement POLLIN
-	// On ne verifie JAMAIS errno apres recv() (interdit par le sujet)
-	ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+	ssize_t	total = 0;
 
-	if (n == 0)
-		return 0; // connexion fermee par le client
-	if (n < 0)
-		return -1; // erreur - fermer la connexion
+	drain_capped = false;
+	while (true)
+	{
+		// Un seul appel recv() par evenement POLLIN (sauf en mode drain)
+		// On ne verifie JAMAIS errno apres recv() (interdit par le sujet)
+		char*	dst = recv_buffer.prepare(RECV_CHUNK);
+		ssize_t n = recv(fd, dst, RECV_CHUNK, 0);
 
-	// std::cout << BOLD_GOLD << totalBytesReceived << RES << std::endl;
+		if (n == 0)
+		{
+			if (total == 0)
+				return 0; // connexion fermee par le client
+			peer_closed = true; // EOF apres des donnees: traiter puis fermer
+			break;
+		}
+		if (n < 0)
+		{
+			if (total == 0)
+				return -1; // erreur - fermer la connexion
+			break; // plus rien a lire pour l'instant
+		}
 
-	recv_buffer.append(buffer, n);
-	totalBytesReceived += recv_buffer.size();
-	if (totalBytesReceived > maxRequestSize) {
-		return -2; // error payload too large
+		recv_buffer.commit(n);
+		total += n;
+		if (!drain || static_cast<size_t>(n) < RECV_CHUNK)
+			break;
+		if (static_cast<size_t>(total) >= RECV_DRAIN_MAX)
+		{
+			drain_capped = true;
+			break;
+		}
 	}
 
-	return n;
+	return total;
 }
 
 
 /**
- * @brief Envoie les donnees de send_buffer
+ * @brief Envoie les donnees de send_buffer, puis le body s'il est a part:
+ * - reponse du file cache (prebuilt): send_buffer et ces bytes partent
+ *   ensemble, un seul sendmsg() (writev() avec MSG_NOSIGNAL)
+ * - fichier: sendfile(), du page cache au socket sans passer par la
+ *   memoire du process
+ * @param drain true en mode edge-triggered: on continue tant que send()
+ * accepte tout, un envoi partiel signifie que le buffer socket est plein
  * @return >0 bytes envoyes, 0 si rien a envoyer, -1 si erreur
  */
-ssize_t Connection::write_pending()
+ssize_t Connection::write_pending(bool drain)
 {
-	if (send_buffer.empty() || bytes_sent >= send_buffer.length())
+	ssize_t	total = 0;
+
+	while (has_pending_data())
 	{
-		return 0;
-	}
+		// Un seul appel send()/sendmsg()/sendfile() par evenement POLLOUT (sauf en mode drain)
+		// On ne verifie JAMAIS errno apres send() (interdit par le sujet)
+		size_t	head = send_buffer.length() - bytes_sent;
+		size_t	shared = prebuilt.size() - prebuilt_sent;
+		size_t	remaining = head + (shared > 0 ? shared : (head > 0 ? 0 : file_remaining));
+		ssize_t	n;
 
-	// Un seul appel send() par evenement POLLOUT
-	// On ne verifie JAMAIS errno apres send() (interdit par le sujet)
-	ssize_t n = send(fd,
-					send_buffer.data() + bytes_sent,
-					send_buffer.length() - bytes_sent,
-					MSG_NOSIGNAL);
+		if (shared > 0)
+		{
+			struct iovec	iov[2];
+			struct msghdr	msg;
 
-	if (n > 0)
-	{
-		bytes_sent += n;
+			std::memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = iov;
+			msg.msg_iovlen = fill_iov(iov);
+			n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+		}
+		// MSG_MORE: les en-tetes partent avec le debut du fichier (sinon Nagle
+		// garde le premier segment du body jusqu'a l'ACK retarde du client)
+		else if (head > 0)
+			n = send(fd, send_buffer.data() + bytes_sent, head,
+				MSG_NOSIGNAL | (file_remaining > 0 ? MSG_MORE : 0));
+		else
+			n = sendfile(fd, file_fd, &file_offset, file_remaining);	// avance file_offset
 
-		// Si tout a ete envoye, nettoyer les buffers
-		if (bytes_sent >= send_buffer.length())
+		if (n <= 0)
 		{
-			send_buffer.clear();
-			bytes_sent = 0;
+			// n <= 0: erreur - fermer la connexion (sauf si on a deja progresse)
+			// (sendfile() == 0: fichier tronque, Content-Length ne sera pas tenu)
+			if (total == 0)
+				return -1;
+			break;
 		}
 
-		return n;
+		size_t	done = static_cast<size_t>(n);
+		total += n;
+		if (advance(done))
+			break;
+		if (!drain || done < remaining)
+			break;
 	}
-	else
-	{
-		// n <= 0: erreur - fermer la connexion
+
+	return total;
+}
+
+/**
+ * @brief Prepare l'envoi par completion (io_uring SENDMSG) de send_buffer et
+ * de la reponse du file cache. send_msg et send_iov restent valides (et les
+ * buffers intouches) tant que send_in_flight, jusqu'a complete_send()
+ * @return NULL si un envoi est deja en cours, s'il n'y a rien a envoyer, ou
+ * si le body est un fichier (sendfile() au POLLOUT, comme sans io_uring)
+ */
+struct msghdr* Connection::prepare_send()
+{
+	if (send_in_flight || file_remaining > 0 || !has_pending_data())
+		return NULL;
+	std::memset(&send_msg, 0, sizeof(send_msg));
+	send_msg.msg_iov = send_iov;
+	send_msg.msg_iovlen = fill_iov(send_iov);
+	send_in_flight = true;
+	return &send_msg;
+}
+
+/**
+ * @brief Resultat de l'envoi prepare par prepare_send()
+ * @param n bytes envoyes, 0 si rien n'est parti (socket plein), <0 si erreur
+ * @return comme write_pending(): >0 bytes envoyes, 0 rien envoye, -1 erreur
+ */
+ssize_t Connection::complete_send(ssize_t n)
+{
+	send_in_flight = false;
+	if (n < 0)
 		return -1;
+	if (n > 0)
+		advance(static_cast<size_t>(n));
+	return n;
+}
+
+// Reste de send_buffer puis de la reponse du file cache (iov[2]): nombre d'iovecs
+int Connection::fill_iov(struct iovec* iov) const
+{
+	size_t	head = send_buffer.length() - bytes_sent;
+	size_t	shared = prebuilt.size() - prebuilt_sent;
+	int		count = 0;
+
+	if (head > 0)
+	{
+		iov[count].iov_base = const_cast<char*>(send_buffer.data() + bytes_sent);
+		iov[count++].iov_len = head;
 	}
+	if (shared > 0)
+	{
+		iov[count].iov_base = const_cast<char*>(prebuilt.data() + prebuilt_sent);
+		iov[count++].iov_len = shared;
+	}
+	return count;
+}
+
+// Compte done bytes envoyes: send_buffer d'abord, le reste pour le body.
+// true si toute la reponse est partie (buffers nettoyes)
+bool Connection::advance(size_t done)
+{
+	size_t	head = send_buffer.length() - bytes_sent;
+	size_t	fromHead = done < head ? done : head;
+
+	bytes_sent += fromHead;
+	if (prebuilt_sent < prebuilt.size())
+		prebuilt_sent += done - fromHead;
+	else
+		file_remaining -= done - fromHead;
+
+	if (has_pending_data())
+		return false;
+	send_buffer.clear();
+	bytes_sent = 0;
+	release_body();
+	return true;
 }
 
-// Verifie si tout le send_buffer a ete envoye
+// Verifie s'il reste une partie de la reponse a envoyer
 bool Connection::has_pending_data() const
 {
-	return (!send_buffer.empty() && bytes_sent < send_buffer.length());
+	return ((!send_buffer.empty() && bytes_sent < send_buffer.length())
+		|| prebuilt_sent < prebuilt.size() || file_remaining > 0);
+}
+
+// Body fichier de la reponse en cours (send_buffer = ses en-tetes):
+// la Connection devient proprietaire du fd et le ferme
+void Connection::send_file(int file, off_t offset, size_t length)
+{
+	release_body();
+	if (length == 0)
+	{
+		close(file);
+		return;
+	}
+	file_fd = file;
+	file_offset = offset;
+	file_remaining = length;
+}
+
+// Reponse du file cache (send_buffer = status line, Connection, Date):
+// partagee avec le cache, pas copiee
+void Connection::send_prebuilt(const SharedBuffer& bytes)
+{
+	release_body();
+	prebuilt = bytes;
+}
+
+// Fin de la reponse: ferme le fichier, lache la reponse du cache
+void Connection::release_body()
+{
+	prebuilt.reset();
+	prebuilt_sent = 0;
+	if (file_fd >= 0)
+		close(file_fd);
+	file_fd = -1;
+	file_offset = 0;
+	file_remaining = 0;
 }
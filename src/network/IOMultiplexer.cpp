@@ -1,30 +1,88 @@
 #include "../../include/network/IOMultiplexer.hpp"
 #include <cerrno>
 #include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <unistd.h>
+
+// Nombre max d'evenements recuperes par appel a epoll_wait()
+static const size_t MAX_EPOLL_EVENTS = 1024;
+
+// Taille du ring de soumission io_uring (le kernel arrondit a une puissance de 2)
+static const unsigned URING_ENTRIES = 4096;
+
+// user_data reserves pour les requetes io_uring qui ne concernent pas un fd
+static const unsigned long long URING_TAG_TIMEOUT = ~0ULL;
+static const unsigned long long URING_TAG_REMOVE = ~0ULL - 1;
 
 IOMultiplexer::MultiplexerException::MultiplexerException(const std::string& message)
 	: std::runtime_error(message)
 {}
 
-IOMultiplexer::IOMultiplexer()
-{}
+IOMultiplexer::IOMultiplexer(EventBackend backend)
+	: _backend(BACKEND_POLL), epoll_fd(-1), uring(), uring_seq(0)
+{
+#ifdef __linux__
+	if (backend == BACKEND_IO_URING)
+	{
+		if (uring.init(URING_ENTRIES))
+		{
+			_backend = BACKEND_IO_URING;
+			return;
+		}
+		backend = BACKEND_EPOLL;	// kernel sans io_uring: on essaie epoll
+	}
+	if (backend == BACKEND_EPOLL)
+	{
+		epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll_fd < 0)
+			throw MultiplexerException("epoll_create1() failed: " + std::string(strerror(errno)));
+		_backend = BACKEND_EPOLL;
+	}
+#else
+	(void)backend;
+#endif
+}
 
 IOMultiplexer::~IOMultiplexer()
-{}
+{
+	if (epoll_fd >= 0)
+		close(epoll_fd);
+}
 
-void IOMultiplexer::add_fd(int fd, short events)
+void IOMultiplexer::add_fd(int fd, short events, bool edge_triggered)
 {
 	if (has_fd(fd))
 	{
 		throw MultiplexerException("fd already exists in multiplexer");
 	}
 
+	edge_triggered = (edge_triggered && supports_edge_triggered());
+#ifdef __linux__
+	if (_backend == BACKEND_EPOLL)
+		epoll_control(EPOLL_CTL_ADD, fd, events, edge_triggered);
+#endif
+	if (_backend == BACKEND_IO_URING)
+		to_arm.push_back(fd);
+
 	struct pollfd pfd;
 	pfd.fd = fd;
 	pfd.events = events;
 	pfd.revents = 0;
 
+	EntryState st;
+	st.edge = edge_triggered;
+	st.armed_tag = 0;
+	st.send_tag = 0;
+	st.send_pos = 0;
+	st.send_done = false;
+	st.send_res = 0;
+	st.reported = false;
+
 	fds.push_back(pfd);
+	state.push_back(st);
+	if (static_cast<size_t>(fd) >= fd_to_index.size())
+		fd_to_index.resize(fd + 1, -1);
 	fd_to_index[fd] = fds.size() - 1;
 }
 
@@ -36,15 +94,28 @@ void IOMultiplexer::remove_fd(int fd)
 
 	size_t idx = fd_to_index[fd];
 
+	// SENDMSG pas encore soumis: ses buffers vont etre liberes par l'appelant
+	if (_backend == BACKEND_IO_URING && state[idx].send_tag != 0)
+		uring.cancel_unsubmitted(state[idx].send_pos);
+	if (_backend == BACKEND_IO_URING)
+		uring_disarm(idx);	// peut basculer sur epoll (uring_failover)
+#ifdef __linux__
+	// Le fd est encore ouvert ici (l'appelant ferme apres remove_fd)
+	if (_backend == BACKEND_EPOLL)
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+#endif
+
 	// Swap avec le dernier element
 	if (idx < fds.size() - 1) {
 		fds[idx] = fds[fds.size() - 1];
+		state[idx] = state[state.size() - 1];
 		// Mettre a jour l'index du fd deplace
 		fd_to_index[fds[idx].fd] = idx;
 	}
 
 	fds.pop_back();
-	fd_to_index.erase(fd);
+	state.pop_back();
+	fd_to_index[fd] = -1;
 }
 
 void IOMultiplexer::modify_fd(int fd, short events)
@@ -54,6 +125,17 @@ void IOMultiplexer::modify_fd(int fd, short events)
 	}
 
 	size_t idx = fd_to_index[fd];
+	if (_backend == BACKEND_IO_URING && fds[idx].events != events)
+	{
+		// Le POLL_ADD en cours surveille les anciens events: on l'annule
+		uring_disarm(idx);	// peut basculer sur epoll (uring_failover)
+		if (_backend == BACKEND_IO_URING)
+			to_arm.push_back(fd);
+	}
+#ifdef __linux__
+	if (_backend == BACKEND_EPOLL)
+		epoll_control(EPOLL_CTL_MOD, fd, events, state[idx].edge);
+#endif
 	fds[idx].events = events;
 	fds[idx].revents = 0;
 }
@@ -62,6 +144,67 @@ std::vector<int> IOMultiplexer::wait(int timeout)
 {
 	std::vector<int> result;
 
+	if (_backend == BACKEND_IO_URING)
+		result = wait_uring(timeout);
+	else if (_backend == BACKEND_EPOLL)
+		result = wait_epoll(timeout);
+	else
+		result = wait_poll(timeout);
+
+	// Sends abandonnes par uring_failover(): leur resultat part avec ce wait()
+	for (size_t i = 0; i < orphan_sends.size(); i++)
+	{
+		int fd = orphan_sends[i];
+		if (index_of(fd) >= 0 && std::find(result.begin(), result.end(), fd) == result.end())
+		{
+			last_ready.push_back(fd);
+			result.push_back(fd);
+		}
+	}
+	orphan_sends.clear();
+	return (result);
+}
+
+bool IOMultiplexer::supports_async_send() const
+{
+	return (_backend == BACKEND_IO_URING);
+}
+
+/*
+	io_uring: SENDMSG soumis avec le prochain wait() (dans le meme
+	io_uring_enter() que les POLL_ADD), son resultat revient comme un
+	evenement du fd (send_result()). MSG_DONTWAIT: un socket plein donne
+	0 byte envoye, l'appelant repasse par POLLOUT.
+*/
+void IOMultiplexer::submit_send(int fd, const struct msghdr* msg)
+{
+	int idx = index_of(fd);
+
+	if (idx < 0 || _backend != BACKEND_IO_URING)
+		return;
+	state[idx].send_tag = uring_tag(fd);
+	int err = uring.prep_sendmsg(fd, msg, MSG_NOSIGNAL | MSG_DONTWAIT,
+								 state[idx].send_tag, state[idx].send_pos);
+	if (err < 0)
+		uring_failover(-err);	// le send devient un orphelin: rien envoye
+}
+
+bool IOMultiplexer::send_result(int fd, ssize_t& n)
+{
+	int idx = index_of(fd);
+
+	if (idx < 0 || !state[idx].send_done)
+		return (false);
+	state[idx].send_done = false;
+	int res = state[idx].send_res;
+	n = (res > 0) ? res : (res == -EAGAIN ? 0 : -1);
+	return (true);
+}
+
+std::vector<int> IOMultiplexer::wait_poll(int timeout)
+{
+	std::vector<int> result;
+
 	if (fds.empty()) {
 		return (result);
 	}
@@ -94,22 +237,331 @@ std::vector<int> IOMultiplexer::wait(int timeout)
 	return (result);
 }
 
+// Les revents du wait() precedent ne doivent pas "fuir" dans le suivant
+void IOMultiplexer::clear_last_ready()
+{
+	for (size_t i = 0; i < last_ready.size(); i++)
+	{
+		int idx = index_of(last_ready[i]);
+		if (idx >= 0)
+		{
+			fds[idx].revents = 0;
+			state[idx].reported = false;
+		}
+	}
+	last_ready.clear();
+}
+
+#ifdef __linux__
+
+// Traduit les flags poll() en flags epoll (et l'inverse plus bas)
+static uint32_t toEpollEvents(short events)
+{
+	uint32_t ev = 0;
+
+	if (events & POLLIN)
+		ev |= EPOLLIN;
+	if (events & POLLOUT)
+		ev |= EPOLLOUT;
+	return (ev);
+}
+
+static short toPollEvents(uint32_t ev)
+{
+	short revents = 0;
+
+	if (ev & EPOLLIN)
+		revents |= POLLIN;
+	if (ev & EPOLLOUT)
+		revents |= POLLOUT;
+	if (ev & EPOLLERR)
+		revents |= POLLERR;
+	if (ev & EPOLLHUP)
+		revents |= POLLHUP;
+	return (revents);
+}
+
+void IOMultiplexer::epoll_control(int op, int fd, short events, bool edge_triggered)
+{
+	struct epoll_event ev;
+
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpollEvents(events);
+	if (edge_triggered)
+		ev.events |= EPOLLET;
+	ev.data.fd = fd;
+
+	if (epoll_ctl(epoll_fd, op, fd, &ev) < 0)
+		throw MultiplexerException("epoll_ctl() failed: " + std::string(strerror(errno)));
+}
+
+std::vector<int> IOMultiplexer::wait_epoll(int timeout)
+{
+	std::vector<int> result;
+
+	clear_last_ready();
+	if (fds.empty()) {
+		return (result);
+	}
+
+	size_t capacity = fds.size() < MAX_EPOLL_EVENTS ? fds.size() : MAX_EPOLL_EVENTS;
+	if (ready_events.size() < capacity)
+		ready_events.resize(capacity);
+
+	int ready = epoll_wait(epoll_fd, &ready_events[0], capacity, timeout);
+
+	if (ready < 0)
+	{
+		// Meme logique que poll(): EINTR n'est pas une erreur fatale
+		if (errno == EINTR)
+			return (result);
+		throw MultiplexerException("epoll_wait() failed: " + std::string(strerror(errno)));
+	}
+
+	// Seuls les fds prets sont parcourus
+	result.reserve(ready);
+	for (int i = 0; i < ready; i++)
+	{
+		int fd = ready_events[i].data.fd;
+		int idx = index_of(fd);
+		if (idx < 0)
+			continue;
+		fds[idx].revents = toPollEvents(ready_events[i].events);
+		last_ready.push_back(fd);
+		result.push_back(fd);
+	}
+
+	return (result);
+}
+
+#else
+
+std::vector<int> IOMultiplexer::wait_epoll(int timeout)
+{
+	return (wait_poll(timeout));
+}
+
+#endif
+
+// Annule le POLL_ADD en cours d'une entree (soumis au prochain wait())
+void IOMultiplexer::uring_disarm(size_t idx)
+{
+	if (state[idx].armed_tag == 0)
+		return;
+	unsigned long long tag = state[idx].armed_tag;
+	state[idx].armed_tag = 0;
+	int err = uring.prep_poll_remove(tag, URING_TAG_REMOVE);
+	if (err < 0)
+		uring_failover(-err);
+}
+
+/*
+	io_uring: POLL_ADD est "one-shot", chaque completion desarme le fd.
+	Les fds a (re)armer sont accumules dans to_arm puis envoyes au kernel
+	en meme temps que l'attente, dans un seul io_uring_enter().
+
+	user_data = (fd << 32) | numero de sequence, une completion dont le tag
+	ne correspond plus a armed_tag (fd retire/modifie entre temps) est ignoree.
+*/
+std::vector<int> IOMultiplexer::wait_uring(int timeout)
+{
+	std::vector<int> result;
+
+	clear_last_ready();
+
+	for (size_t i = 0; i < to_arm.size(); i++)
+	{
+		int idx = index_of(to_arm[i]);
+		if (idx < 0 || state[idx].armed_tag != 0)
+			continue;
+		unsigned long long tag = uring_tag(to_arm[i]);
+		int err = uring.prep_poll_add(to_arm[i], fds[idx].events, tag);
+		if (err < 0)
+		{
+			uring_failover(-err);
+			return (wait(timeout));
+		}
+		state[idx].armed_tag = tag;
+	}
+	to_arm.clear();
+
+	if (fds.empty()) {
+		uring.submit_and_wait(0);	// envoyer quand meme les POLL_REMOVE en attente
+		return (result);
+	}
+
+	unsigned min_complete = (timeout == 0) ? 0 : 1;
+	int err = (timeout > 0) ? uring.prep_timeout(timeout, URING_TAG_TIMEOUT) : 0;
+	if (err < 0)
+	{
+		uring_failover(-err);
+		return (wait(timeout));
+	}
+
+	/*
+		EINTR: meme logique que poll(), rien n'a ete soumis, on reessaie au
+		prochain tour. EBUSY: le ring de completion deborde, le kernel refuse
+		de soumettre tant qu'on ne l'a pas vide -> on depile quand meme (les
+		SQEs restent en attente). Toute autre erreur rend le ring inutilisable.
+	*/
+	int ret = uring.submit_and_wait(min_complete);
+	if (ret == -EINTR)
+		return (result);
+	if (ret < 0 && ret != -EBUSY)
+	{
+		uring_failover(-ret);
+		return (wait(timeout));
+	}
+
+	uring_reap(&result);
+	return (result);
+}
+
+/*
+	Depile les completions. Un fd n'apparait qu'une fois dans result, meme
+	si son POLL_ADD et son SENDMSG se terminent dans le meme wait().
+	result == NULL (uring_failover): seuls les resultats des sends sont
+	gardes, epoll/poll retrouveront les fds prets.
+*/
+void IOMultiplexer::uring_reap(std::vector<int>* result)
+{
+	unsigned long long	tag;
+	int					res;
+
+	while (uring.next_completion(tag, res))
+	{
+		if (tag == URING_TAG_TIMEOUT || tag == URING_TAG_REMOVE)
+			continue;
+
+		int fd = static_cast<int>(tag >> 32);
+		int idx = index_of(fd);
+		if (idx < 0)
+			continue;	// completion perimee (fd retire)
+
+		if (tag == state[idx].send_tag)
+		{
+			state[idx].send_tag = 0;
+			state[idx].send_done = true;
+			state[idx].send_res = res;
+			if (result == NULL)
+				orphan_sends.push_back(fd);
+		}
+		else if (tag == state[idx].armed_tag && result != NULL)
+		{
+			// Une completion annulee (-ECANCELED) ou en erreur remonte comme POLLERR
+			state[idx].armed_tag = 0;
+			fds[idx].revents = (res < 0) ? POLLERR : static_cast<short>(res);
+			to_arm.push_back(fd);
+		}
+		else
+			continue;	// completion perimee (annulee, fd modifie ou reutilise)
+
+		if (result != NULL && !state[idx].reported)
+		{
+			state[idx].reported = true;
+			last_ready.push_back(fd);
+			result->push_back(fd);
+		}
+	}
+}
+
+// user_data d'une requete sur fd: (fd << 32) | numero de sequence
+unsigned long long IOMultiplexer::uring_tag(int fd)
+{
+	uring_seq = (uring_seq + 1) & 0xffffffffULL;
+	if (uring_seq == 0)
+		uring_seq = 1;	// sinon le tag du fd 0 vaudrait 0 ("pas arme")
+	return ((static_cast<unsigned long long>(fd) << 32) | uring_seq);
+}
+
+/*
+	io_uring_enter() en erreur (EBADF, ENOMEM, EFAULT..., ou ring de
+	soumission plein qui ne peut plus etre soumis, voir get_sqe): on bascule sur
+	epoll (ou poll) plutot que de tourner a vide. Les POLL_ADD en cours sont
+	abandonnes, tous les fds sont re-enregistres en level-triggered (edge est
+	toujours false sous io_uring, voir supports_edge_triggered()).
+	Les SENDMSG deja traites gardent leur resultat, ceux jamais soumis
+	rendent "rien envoye": l'appelant repasse par POLLOUT.
+*/
+void IOMultiplexer::uring_failover(int err)
+{
+	std::cerr << "✗ io_uring_enter() failed: " << strerror(err) << ", falling back to ";
+
+	uring_reap(NULL);
+	to_arm.clear();
+	for (size_t i = 0; i < state.size(); i++)
+	{
+		state[i].armed_tag = 0;
+		if (state[i].send_tag != 0)
+		{
+			state[i].send_tag = 0;
+			state[i].send_done = true;
+			state[i].send_res = -EAGAIN;
+			orphan_sends.push_back(fds[i].fd);
+		}
+	}
+	_backend = BACKEND_POLL;
+
+#ifdef __linux__
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd >= 0)
+	{
+		_backend = BACKEND_EPOLL;
+		try {
+			for (size_t i = 0; i < fds.size(); i++)
+				epoll_control(EPOLL_CTL_ADD, fds[i].fd, fds[i].events, false);
+		} catch (const MultiplexerException&) {
+			close(epoll_fd);
+			epoll_fd = -1;
+			_backend = BACKEND_POLL;
+		}
+	}
+#endif
+	std::cerr << backend_name() << std::endl;
+}
+
+int IOMultiplexer::index_of(int fd) const
+{
+	if (fd < 0 || static_cast<size_t>(fd) >= fd_to_index.size())
+		return (-1);
+	return (fd_to_index[fd]);
+}
+
 short IOMultiplexer::get_revents(int fd) const
 {
-	std::map<int, size_t>::const_iterator it = fd_to_index.find(fd);
-	if (it == fd_to_index.end())
+	int idx = index_of(fd);
+	if (idx < 0)
 	{
 		return (0);
 	}
-	return (fds[it->second].revents);
+	return (fds[idx].revents);
 }
 
 bool IOMultiplexer::has_fd(int fd) const
 {
-	return (fd_to_index.find(fd) != fd_to_index.end());
+	return (index_of(fd) >= 0);
 }
 
 size_t IOMultiplexer::size() const
 {
 	return (fds.size());
 }
+
+EventBackend IOMultiplexer::backend() const
+{
+	return (_backend);
+}
+
+bool IOMultiplexer::supports_edge_triggered() const
+{
+	return (_backend == BACKEND_EPOLL);
+}
+
+const char* IOMultiplexer::backend_name() const
+{
+	if (_backend == BACKEND_IO_URING)
+		return ("io_uring");
+	if (_backend == BACKEND_EPOLL)
+		return ("epoll");
+	return ("poll");
+}
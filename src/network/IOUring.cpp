@@ -0,0 +1,334 @@
+#include "../../include/network/IOUring.hpp"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+#endif
+
+IOUring::IOUring()
+	: ring_fd(-1), pending(0),
+	  sq_ptr(NULL), sq_size(0), sq_head(NULL), sq_tail(NULL), sq_mask(NULL),
+	  sq_entries(NULL), sq_array(NULL), sqes(NULL), sqes_size(0),
+	  cq_ptr(NULL), cq_size(0), cq_head(NULL), cq_tail(NULL), cq_mask(NULL),
+	  cqes(NULL)
+{
+	timeout_ts[0] = 0;
+	timeout_ts[1] = 0;
+}
+
+IOUring::~IOUring()
+{
+	release();
+}
+
+bool IOUring::is_ready() const
+{
+	return (ring_fd >= 0);
+}
+
+#ifdef __linux__
+
+// Les index head/tail sont partages avec le kernel: acces avec barrieres
+static unsigned loadAcquire(const unsigned* p)
+{
+	return (__atomic_load_n(p, __ATOMIC_ACQUIRE));
+}
+
+static void storeRelease(unsigned* p, unsigned v)
+{
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+void IOUring::release()
+{
+	if (sqes != NULL)
+		munmap(sqes, sqes_size);
+	if (cq_ptr != NULL && cq_ptr != sq_ptr)
+		munmap(cq_ptr, cq_size);
+	if (sq_ptr != NULL)
+		munmap(sq_ptr, sq_size);
+	if (ring_fd >= 0)
+		close(ring_fd);
+	sqes = NULL;
+	cq_ptr = NULL;
+	sq_ptr = NULL;
+	ring_fd = -1;
+}
+
+bool IOUring::init(unsigned entries)
+{
+	struct io_uring_params p;
+
+	std::memset(&p, 0, sizeof(p));
+	ring_fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring_fd < 0)
+		return (false);	// ENOSYS (vieux kernel), EPERM (desactive), ...
+
+	sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (cq_size > sq_size)
+			sq_size = cq_size;
+		cq_size = sq_size;
+	}
+
+	sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				  ring_fd, IORING_OFF_SQ_RING);
+	if (sq_ptr == MAP_FAILED)
+	{
+		sq_ptr = NULL;
+		release();
+		return (false);
+	}
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		cq_ptr = sq_ptr;
+	else
+	{
+		cq_ptr = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					  ring_fd, IORING_OFF_CQ_RING);
+		if (cq_ptr == MAP_FAILED)
+		{
+			cq_ptr = NULL;
+			release();
+			return (false);
+		}
+	}
+
+	sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				ring_fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+	{
+		sqes = NULL;
+		release();
+		return (false);
+	}
+
+	char* sq = static_cast<char*>(sq_ptr);
+	sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+	sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+	sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+	sq_entries = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_entries);
+	sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+
+	char* cq = static_cast<char*>(cq_ptr);
+	cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+	cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+	cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+	cqes = cq + p.cq_off.cqes;
+
+	return (true);
+}
+
+/*
+	Retourne un SQE libre (deja remis a zero). Si le ring de soumission est
+	plein, on soumet d'abord ce qui est en attente (sans attendre de completion).
+	Si cette soumission echoue, NULL et err = -errno: le SQE libre serait un
+	SQE pas encore soumis, on ne l'ecrase pas.
+*/
+void* IOUring::get_sqe(int& err)
+{
+	unsigned tail = *sq_tail;
+
+	err = 0;
+	if (tail - loadAcquire(sq_head) >= *sq_entries)
+	{
+		do
+			err = submit_and_wait(0);
+		while (err == -EINTR);
+		if (err == 0 && tail - loadAcquire(sq_head) >= *sq_entries)
+			err = -EBUSY;	// le kernel n'a rien consomme
+		if (err < 0)
+			return (NULL);
+	}
+
+	unsigned idx = tail & *sq_mask;
+	struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes) + idx;
+
+	std::memset(sqe, 0, sizeof(*sqe));
+	sq_array[idx] = idx;
+	storeRelease(sq_tail, tail + 1);
+	pending++;
+	return (sqe);
+}
+
+int IOUring::prep_poll_add(int fd, short events, unsigned long long user_data)
+{
+	int						err;
+	struct io_uring_sqe*	sqe = static_cast<struct io_uring_sqe*>(get_sqe(err));
+
+	if (sqe == NULL)
+		return (err);
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = static_cast<unsigned short>(events);
+	sqe->user_data = user_data;
+	return (0);
+}
+
+int IOUring::prep_poll_remove(unsigned long long target, unsigned long long user_data)
+{
+	int						err;
+	struct io_uring_sqe*	sqe = static_cast<struct io_uring_sqe*>(get_sqe(err));
+
+	if (sqe == NULL)
+		return (err);
+	sqe->opcode = IORING_OP_POLL_REMOVE;
+	sqe->fd = -1;
+	sqe->addr = target;
+	sqe->user_data = user_data;
+	return (0);
+}
+
+/*
+	SENDMSG: msg et ses iovecs sont lus quand le kernel traite le SQE.
+	Avec MSG_DONTWAIT le kernel ne garde pas la requete en attente (pas de
+	poll interne): socket plein -> completion -EAGAIN, pendant le meme
+	io_uring_enter(). Une fois soumis, le kernel ne lit donc plus ces buffers.
+	pos = position du SQE dans le ring, pour cancel_unsubmitted().
+*/
+int IOUring::prep_sendmsg(int fd, const struct msghdr* msg, unsigned flags,
+						  unsigned long long user_data, unsigned& pos)
+{
+	int						err;
+	struct io_uring_sqe*	sqe = static_cast<struct io_uring_sqe*>(get_sqe(err));
+
+	if (sqe == NULL)
+		return (err);
+	pos = *sq_tail - 1;
+	sqe->opcode = IORING_OP_SENDMSG;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<unsigned long>(msg);
+	sqe->len = 1;
+	sqe->msg_flags = flags;
+	sqe->user_data = user_data;
+	return (0);
+}
+
+// Un SQE pas encore consomme par le kernel appartient encore au process:
+// on le transforme en NOP (sa completion, avec le meme user_data, est ignoree)
+bool IOUring::cancel_unsubmitted(unsigned pos)
+{
+	unsigned head = loadAcquire(sq_head);
+
+	if (pos - head >= *sq_tail - head)
+		return (false);	// deja soumis
+
+	struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes) + (pos & *sq_mask);
+	unsigned long long user_data = sqe->user_data;
+	std::memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_NOP;
+	sqe->user_data = user_data;
+	return (true);
+}
+
+/*
+	Le timeout se termine apres timeout_ms OU des qu'une autre completion
+	arrive (off = 1), il ne s'accumule donc pas d'un wait() a l'autre.
+*/
+int IOUring::prep_timeout(int timeout_ms, unsigned long long user_data)
+{
+	int						err;
+	struct io_uring_sqe*	sqe = static_cast<struct io_uring_sqe*>(get_sqe(err));
+
+	if (sqe == NULL)
+		return (err);
+	timeout_ts[0] = timeout_ms / 1000;
+	timeout_ts[1] = (timeout_ms % 1000) * 1000000LL;
+
+	sqe->opcode = IORING_OP_TIMEOUT;
+	sqe->fd = -1;
+	sqe->addr = reinterpret_cast<unsigned long>(timeout_ts);
+	sqe->len = 1;
+	sqe->off = 1;
+	sqe->user_data = user_data;
+	return (0);
+}
+
+int IOUring::submit_and_wait(unsigned min_complete)
+{
+	unsigned flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+
+	if (pending == 0 && min_complete == 0)
+		return (0);
+
+	int ret = syscall(__NR_io_uring_enter, ring_fd, pending, min_complete, flags, NULL, 0);
+	if (ret < 0)
+		return (-errno);	// rien n'a ete soumis: pending reste pour le prochain appel
+	pending = (static_cast<unsigned>(ret) >= pending) ? 0 : pending - ret;
+	return (0);
+}
+
+bool IOUring::next_completion(unsigned long long& user_data, int& res)
+{
+	unsigned head = *cq_head;
+
+	if (head == loadAcquire(cq_tail))
+		return (false);
+
+	struct io_uring_cqe* cqe = static_cast<struct io_uring_cqe*>(cqes) + (head & *cq_mask);
+	user_data = cqe->user_data;
+	res = cqe->res;
+	storeRelease(cq_head, head + 1);
+	return (true);
+}
+
+#else
+
+void IOUring::release()
+{}
+
+bool IOUring::init(unsigned entries)
+{
+	(void)entries;
+	return (false);
+}
+
+void* IOUring::get_sqe(int& err)
+{
+	err = -ENOSYS;
+	return (NULL);
+}
+
+int IOUring::prep_poll_add(int, short, unsigned long long)
+{
+	return (-ENOSYS);
+}
+
+int IOUring::prep_poll_remove(unsigned long long, unsigned long long)
+{
+	return (-ENOSYS);
+}
+
+int IOUring::prep_timeout(int, unsigned long long)
+{
+	return (-ENOSYS);
+}
+
+int IOUring::prep_sendmsg(int, const struct msghdr*, unsigned, unsigned long long, unsigned&)
+{
+	return (-ENOSYS);
+}
+
+bool IOUring::cancel_unsubmitted(unsigned)
+{
+	return (false);
+}
+
+int IOUring::submit_and_wait(unsigned)
+{
+	return (0);
+}
+
+bool IOUring::next_completion(unsigned long long&, int&)
+{
+	return (false);
+}
+
+#endif
@@ -0,0 +1,260 @@
+#include "network/MasterProcess.hpp"
+#include "network/Server.hpp"
+#include "network/SocketManager.hpp"
+#include "colours.hpp"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Un worker qui meurt moins de RESPAWN_DELAY secondes apres son lancement
+// (ou un fork() en echec) n'est relance qu'apres ce delai (evite une boucle
+// de fork si le crash est immediat). Le master ne dort pas: SIGALRM le
+// reveille dans sigsuspend() quand le delai est passe
+static const int RESPAWN_DELAY = 1;
+
+// Flags positionnes par les handlers du master
+static volatile sig_atomic_t g_stop = 0;
+static volatile sig_atomic_t g_hup = 0;
+static volatile sig_atomic_t g_child = 0;
+
+// Server du worker courant (un seul par processus)
+static Server* g_worker = NULL;
+
+static void masterHandler(int signal)
+{
+	if (signal == SIGINT || signal == SIGTERM)
+		g_stop = 1;
+	else if (signal == SIGHUP)
+		g_hup = 1;
+	else if (signal == SIGCHLD)
+		g_child = 1;
+	// SIGALRM: rien a faire, il sort juste le master de sigsuspend()
+}
+
+static void workerHandler(int signal)
+{
+	(void)signal;
+	if (g_worker)
+		g_worker->stop();
+}
+
+// Pas de SA_RESTART: les appels bloquants (poll, epoll_wait...) retournent EINTR
+static void installHandler(int signal, void (*handler)(int))
+{
+	struct sigaction sa;
+
+	std::memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+	sigaction(signal, &sa, NULL);
+}
+
+MasterProcess::MasterException::MasterException(const std::string& message)
+	: std::runtime_error(message)
+{}
+
+MasterProcess::MasterProcess(const Config& cfg)
+	: config(&cfg), workers(cfg.workerProcesses)
+{
+	SocketManager socket_manager;
+
+	std::cout << BOLD_CYAN << "=== Initializing Master Process ===" << RES << std::endl;
+
+	try {
+		for (size_t i = 0; i < cfg.servers.size(); i++)
+		{
+			int fd = socket_manager.create_server(cfg.servers[i].port, cfg.servers[i].backlog);
+			listen_fds.push_back(fd);
+			std::cout << GREEN << "✓ " << RES << "Server socket created: "
+					  << "fd=" << fd << " (port " << cfg.servers[i].port << ")" << std::endl;
+		}
+	} catch (...)
+	{
+		for (size_t i = 0; i < listen_fds.size(); i++)
+			SocketManager::close_socket(listen_fds[i]);
+		listen_fds.clear();
+		throw;
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].pid = -1;
+		workers[i].started = 0;
+		workers[i].respawn_at = 0;
+	}
+}
+
+MasterProcess::~MasterProcess()
+{
+	for (size_t i = 0; i < listen_fds.size(); i++)
+		SocketManager::close_socket(listen_fds[i]);
+	listen_fds.clear();
+}
+
+void MasterProcess::run()
+{
+	sigset_t	block;
+	sigset_t	orig;
+
+	// Les signaux ne sont traites que dans sigsuspend(): pas de course
+	// entre le test des flags et la mise en attente
+	sigemptyset(&block);
+	sigaddset(&block, SIGINT);
+	sigaddset(&block, SIGTERM);
+	sigaddset(&block, SIGHUP);
+	sigaddset(&block, SIGCHLD);
+	sigaddset(&block, SIGALRM);
+	if (sigprocmask(SIG_BLOCK, &block, &orig) < 0)
+		throw MasterException("sigprocmask() failed: " + std::string(strerror(errno)));
+
+	installHandler(SIGINT, masterHandler);
+	installHandler(SIGTERM, masterHandler);
+	installHandler(SIGHUP, masterHandler);
+	installHandler(SIGCHLD, masterHandler);
+	installHandler(SIGALRM, masterHandler);
+
+	for (size_t i = 0; i < workers.size(); i++)
+		spawnWorker(i);
+
+	std::cout << GREEN << "✓ " << RES << "Master pid=" << getpid() << " supervising "
+			  << workers.size() << " worker" << (workers.size() > 1 ? "s" : "")
+			  << " (SIGHUP restarts them, Ctrl+C to stop)\n" << std::endl;
+
+	while (!g_stop)
+	{
+		if (!g_hup && !g_child)
+			sigsuspend(&orig);
+		if (g_child)
+		{
+			g_child = 0;
+			reapWorkers();
+		}
+		if (g_hup && !g_stop)
+		{
+			g_hup = 0;
+			std::cout << "Received SIGHUP, restarting workers..." << std::endl;
+			forwardSignal(SIGHUP);
+		}
+		// Relancer les slots vides (worker mort ou fork() en echec), sauf
+		// ceux dont le delai de relance n'est pas encore passe
+		bool	delayed = false;
+		time_t	now = std::time(NULL);
+		for (size_t i = 0; i < workers.size() && !g_stop; i++)
+		{
+			if (workers[i].pid >= 0)
+				continue;
+			if (now >= workers[i].respawn_at)
+				spawnWorker(i);
+			if (workers[i].pid < 0)
+				delayed = true;	// pas encore l'heure, ou fork() en echec
+		}
+		if (delayed && !g_stop)
+			alarm(RESPAWN_DELAY);
+	}
+	alarm(0);
+
+	std::cout << std::endl << "Received SIGINT, stopping workers..." << std::endl;
+	forwardSignal(SIGINT);
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		if (workers[i].pid > 0)
+			waitpid(workers[i].pid, NULL, 0);
+		workers[i].pid = -1;
+	}
+	sigprocmask(SIG_SETMASK, &orig, NULL);
+	std::cout << GREEN << "✓ " << RES << "All workers stopped" << std::endl;
+}
+
+void MasterProcess::spawnWorker(size_t slot)
+{
+	std::cout.flush();	// sinon le buffer du master serait ecrit aussi par le fils
+	pid_t pid = fork();
+
+	if (pid < 0)
+	{
+		std::cerr << "✗ Master Error: fork() failed: " << strerror(errno) << std::endl;
+		workers[slot].respawn_at = std::time(NULL) + RESPAWN_DELAY;
+		return;	// nouvelle tentative par run() une fois le delai passe
+	}
+	if (pid == 0)
+	{
+		workerMain();
+		std::exit(0);
+	}
+	workers[slot].pid = pid;
+	workers[slot].started = std::time(NULL);
+	workers[slot].respawn_at = 0;
+	std::cout << GREEN << "✓ " << RES << "Worker " << slot << " started: pid=" << pid << std::endl;
+}
+
+// Code execute dans le fils: un Server classique sur les sockets herites
+void MasterProcess::workerMain()
+{
+	sigset_t	none;
+
+	installHandler(SIGINT, workerHandler);
+	installHandler(SIGTERM, workerHandler);
+	installHandler(SIGHUP, workerHandler);
+	signal(SIGCHLD, SIG_DFL);
+	signal(SIGALRM, SIG_DFL);
+	sigemptyset(&none);
+	sigprocmask(SIG_SETMASK, &none, NULL);
+
+	try {
+		Server server(*config, listen_fds);
+		listen_fds.clear();	// le Server les fermera
+		g_worker = &server;
+		server.run();
+		g_worker = NULL;
+	} catch (const std::exception& e)
+	{
+		g_worker = NULL;
+		std::cerr << "✗ Worker Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+}
+
+void MasterProcess::reapWorkers()
+{
+	int		status;
+	pid_t	pid;
+
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+	{
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			if (workers[i].pid != pid)
+				continue;
+
+			bool crashed = WIFSIGNALED(status) || (WIFEXITED(status) && WEXITSTATUS(status) != 0);
+			if (WIFSIGNALED(status))
+				std::cerr << "✗ Worker " << i << " (pid=" << pid << ") killed by signal "
+						  << WTERMSIG(status) << std::endl;
+			else if (crashed)
+				std::cerr << "✗ Worker " << i << " (pid=" << pid << ") exited with status "
+						  << WEXITSTATUS(status) << std::endl;
+
+			// Le slot sera relance par run() (sauf pendant l'arret), plus tard
+			// s'il vient de crasher: reapWorkers() ne bloque jamais
+			workers[i].pid = -1;
+			time_t now = std::time(NULL);
+			if (crashed && now - workers[i].started < RESPAWN_DELAY)
+				workers[i].respawn_at = now + RESPAWN_DELAY;
+			break;
+		}
+	}
+}
+
+void MasterProcess::forwardSignal(int sig)
+{
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		if (workers[i].pid > 0)
+			kill(workers[i].pid, sig);
+	}
+}
@@ -0,0 +1,125 @@
+#include "network/ReactorPool.hpp"
+#include "colours.hpp"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+
+ReactorPool::PoolException::PoolException(const std::string& message)
+	: std::runtime_error(message)
+{}
+
+// Handler vide: SIGUSR1 sert uniquement a faire sortir un reactor de wait() (EINTR)
+static void wakeupHandler(int signal)
+{
+	(void)signal;
+}
+
+ReactorPool::ReactorPool(const Config& cfg)
+{
+	try {
+		for (int i = 0; i < cfg.workerThreads; i++)
+		{
+			std::cout << BOLD_CYAN << "--- Reactor " << i << " ---" << RES << std::endl;
+
+			Reactor r;
+			r.server = NULL;
+			r.started = false;
+			r.server = new Server(cfg, true);
+			reactors.push_back(r);
+		}
+	} catch (...)
+	{
+		for (size_t i = 0; i < reactors.size(); i++)
+			delete reactors[i].server;
+		reactors.clear();
+		throw;
+	}
+}
+
+ReactorPool::~ReactorPool()
+{
+	stopAll();
+	joinAll();
+	for (size_t i = 0; i < reactors.size(); i++)
+		delete reactors[i].server;
+	reactors.clear();
+}
+
+void* ReactorPool::reactorMain(void* arg)
+{
+	Server* server = static_cast<Server*>(arg);
+
+	try {
+		server->run();
+	} catch (const std::exception& e)
+	{
+		// Un reactor qui meurt arrete tout le pool (comme le serveur mono-thread)
+		std::cerr << "✗ Reactor Error: " << e.what() << std::endl;
+		kill(getpid(), SIGINT);
+	}
+	return (NULL);
+}
+
+void ReactorPool::run()
+{
+	struct sigaction	sa;
+	sigset_t			set;
+	int					sig;
+
+	std::memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = wakeupHandler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;	// pas de SA_RESTART
+	if (sigaction(SIGUSR1, &sa, NULL) < 0)
+		throw PoolException("sigaction(SIGUSR1) failed: " + std::string(strerror(errno)));
+
+	// Bloque avant pthread_create: les threads heritent du masque
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	int err = pthread_sigmask(SIG_BLOCK, &set, NULL);
+	if (err != 0)
+		throw PoolException("pthread_sigmask() failed: " + std::string(strerror(err)));
+
+	for (size_t i = 0; i < reactors.size(); i++)
+	{
+		err = pthread_create(&reactors[i].thread, NULL, &ReactorPool::reactorMain, reactors[i].server);
+		if (err != 0)
+		{
+			stopAll();
+			joinAll();
+			throw PoolException("pthread_create() failed: " + std::string(strerror(err)));
+		}
+		reactors[i].started = true;
+	}
+
+	std::cout << GREEN << "✓ " << RES << reactors.size() << " reactors running" << std::endl;
+
+	while (sigwait(&set, &sig) != 0)
+		;
+	std::cout << std::endl << "Received SIGINT, stopping server..." << std::endl;
+
+	stopAll();
+	joinAll();
+}
+
+void ReactorPool::stopAll()
+{
+	for (size_t i = 0; i < reactors.size(); i++)
+	{
+		reactors[i].server->stop();
+		if (reactors[i].started)
+			pthread_kill(reactors[i].thread, SIGUSR1);
+	}
+}
+
+void ReactorPool::joinAll()
+{
+	for (size_t i = 0; i < reactors.size(); i++)
+	{
+		if (reactors[i].started)
+			pthread_join(reactors[i].thread, NULL);
+		reactors[i].started = false;
+	}
+}
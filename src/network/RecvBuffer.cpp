@@ -0,0 +1,112 @@
+#include "network/RecvBuffer.hpp"
+#include <cstring>
+
+RecvBuffer::RecvBuffer()
+	: storage(), rpos(0), wpos(0)
+{}
+
+/*
+	Compaction seulement quand elle est rentable: si le prefixe consomme est
+	au moins aussi grand que les donnees vivantes, le memmove coute moins que
+	la place recuperee. Sinon on agrandit, en ne recopiant que les donnees
+	vivantes (jamais le prefixe consomme).
+*/
+char* RecvBuffer::prepare(size_t n)
+{
+	if (storage.size() - wpos >= n)
+		return (&storage[0] + wpos);
+
+	size_t live = wpos - rpos;
+	if (rpos >= live && storage.size() - live >= n)
+	{
+		std::memmove(&storage[0], &storage[0] + rpos, live);
+	}
+	else
+	{
+		size_t grown = storage.size() * 2;
+		if (grown < live + n)
+			grown = live + n;
+		std::vector<char> bigger(grown);
+		if (live > 0)
+			std::memcpy(&bigger[0], &storage[0] + rpos, live);
+		storage.swap(bigger);
+	}
+	rpos = 0;
+	wpos = live;
+	return (&storage[0] + wpos);
+}
+
+void RecvBuffer::commit(size_t n)
+{
+	wpos += n;
+}
+
+void RecvBuffer::append(const char* src, size_t n)
+{
+	if (n == 0)
+		return;
+	std::memcpy(prepare(n), src, n);
+	commit(n);
+}
+
+const char* RecvBuffer::data() const
+{
+	return (storage.empty() ? NULL : &storage[0] + rpos);
+}
+
+size_t RecvBuffer::size() const
+{
+	return (wpos - rpos);
+}
+
+bool RecvBuffer::empty() const
+{
+	return (wpos == rpos);
+}
+
+size_t RecvBuffer::capacity() const
+{
+	return (storage.size());
+}
+
+void RecvBuffer::consume(size_t n)
+{
+	rpos += n;
+	// Tout est lu: on repart du debut, sans memmove
+	if (rpos >= wpos)
+	{
+		rpos = 0;
+		wpos = 0;
+	}
+}
+
+void RecvBuffer::clear()
+{
+	rpos = 0;
+	wpos = 0;
+}
+
+size_t RecvBuffer::findCRLF(size_t from) const
+{
+	const char*	base = data();
+	size_t		len = size();
+
+	while (from + 1 < len)
+	{
+		const void* cr = std::memchr(base + from, '\r', len - from - 1);
+		if (cr == NULL)
+			return (npos);
+		size_t pos = static_cast<const char*>(cr) - base;
+		if (base[pos + 1] == '\n')
+			return (pos);
+		from = pos + 1;
+	}
+	return (npos);
+}
+
+void RecvBuffer::recycle(size_t capacity_cap)
+{
+	clear();
+	if (storage.size() > capacity_cap)
+		std::vector<char>().swap(storage);
+}
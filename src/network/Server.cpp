@@ -1,4 +1,5 @@
 #include "network/Server.hpp"
+#include "network/Clock.hpp"
 #include "http/Status.hpp"
 #include "router/Router.hpp"
 #include "cgi/CgiHandler.hpp"
@@ -10,12 +11,32 @@
 #include <sstream>
 #include <ctime>
 #include <sys/wait.h>
+#include <sys/socket.h>
 #include <csignal>
 #include <unistd.h>
 
 // Timeout pour les connexions clients inactives (en secondes)
 static const int CLIENT_TIMEOUT_SECONDS = 15;
 
+// Attente max dans wait() meme sans timer arme: un stop() venu d'un autre
+// thread juste avant wait() (signal perdu) est pris en compte au pire apres ce delai
+static const int MAX_WAIT_MS = 5000;
+
+// ObjectPool: objets gardes au plus par pool, et capacite max conservee par
+// buffer (au-dela, la memoire d'un gros upload est rendue au recyclage)
+static const size_t POOL_MAX_FREE = 1024;
+static const size_t POOL_BUFFER_CAP = 64 * 1024;
+
+// Body streame vers un CGI: au-dela de ce retard (bytes recus mais pas encore
+// lus par le script), on arrete de lire le client jusqu'a ce que le pipe se vide
+static const size_t CGI_STDIN_BACKLOG = 256 * 1024;
+
+// Fermeture "lingering" (reponse envoyee avant la fin du body): apres
+// shutdown(SHUT_WR), on lit et jette au plus ce volume pendant ce delai
+// avant close(), sinon des bytes non lus feraient envoyer un RST au client
+static const unsigned long long LINGER_TIMEOUT_MS = 5000;
+static const size_t LINGER_MAX_BYTES = 1024 * 1024;
+
 // Helper function pour convertir int en string (C++98)
 std::string intToString(int n)
 {
@@ -28,8 +49,14 @@ Server::ServerException::ServerException(const std::string& message)
 	: std::runtime_error(message)
 {}
 
-Server::Server(const Config& cfg, int backlog)
-	: socket_manager(), multiplexer(), clients(), config(&cfg), running(false)
+Server::Server(const Config& cfg, bool reuse_port)
+	: socket_manager(), multiplexer(cfg.eventBackend), timers(), slots(),
+	  conn_pool(POOL_MAX_FREE, POOL_BUFFER_CAP), parser_pool(POOL_MAX_FREE, POOL_BUFFER_CAP),
+	  cgi_pool(POOL_MAX_FREE, POOL_BUFFER_CAP), file_cache(cfg.fileCacheSize, cfg.fileCacheMaxEntry),
+	  open_file_cache(cfg.openFileCacheMax, cfg.openFileCacheValid),
+	  config(&cfg), running(true),
+	  edge_triggered(cfg.edgeTriggered && multiplexer.supports_edge_triggered()),
+	  stats_accepted(0), stats_dropped(0)
 	{
 
 	std::cout << BOLD_CYAN << "=== Initializing Multi-Port Server ===" << RES << std::endl;
@@ -48,11 +75,12 @@ Server::Server(const Config& cfg, int backlog)
 			std::cout << BOLD_CYAN << "Setting up server on port " << port << "..." << RES << std::endl;
 
 			// Creer le socket serveur
-			int fd = socket_manager.create_server(port, backlog);
+			int fd = socket_manager.create_server(port, cfg.servers[i].backlog, reuse_port);
 
 			// Stocker le fd et sa config associée
 			server_fds.push_back(fd);
-			fd_to_server[fd] = &cfg.servers[i];
+			slot(fd).type = FD_LISTEN;
+			slot(fd).server = &cfg.servers[i];
 
 			// Ajouter au multiplexer pour surveiller les nouvelles connexions
 			multiplexer.add_fd(fd, POLLIN);
@@ -68,7 +96,7 @@ Server::Server(const Config& cfg, int backlog)
 			SocketManager::close_socket(server_fds[i]);
 		}
 		server_fds.clear();
-		fd_to_server.clear();
+		slots.clear();
 		throw;
 	}
 
@@ -76,15 +104,51 @@ Server::Server(const Config& cfg, int backlog)
 			  << server_fds.size() << " port" << (server_fds.size() > 1 ? "s" : "") << ")" << std::endl;
 }
 
+// worker_processes: les sockets ont ete crees par le master avant fork(),
+// listen_fds[i] correspond a cfg.servers[i]. Le worker en devient proprietaire
+Server::Server(const Config& cfg, const std::vector<int>& listen_fds)
+	: socket_manager(), multiplexer(cfg.eventBackend), timers(), slots(),
+	  conn_pool(POOL_MAX_FREE, POOL_BUFFER_CAP), parser_pool(POOL_MAX_FREE, POOL_BUFFER_CAP),
+	  cgi_pool(POOL_MAX_FREE, POOL_BUFFER_CAP), file_cache(cfg.fileCacheSize, cfg.fileCacheMaxEntry),
+	  open_file_cache(cfg.openFileCacheMax, cfg.openFileCacheValid),
+	  config(&cfg), running(true),
+	  edge_triggered(cfg.edgeTriggered && multiplexer.supports_edge_triggered()),
+	  stats_accepted(0), stats_dropped(0)
+{
+	if (listen_fds.size() != cfg.servers.size())
+	{
+		throw ServerException("Inherited listen sockets do not match server blocks");
+	}
+
+	server_fds = listen_fds;
+	for (size_t i = 0; i < server_fds.size(); i++)
+	{
+		slot(server_fds[i]).type = FD_LISTEN;
+		slot(server_fds[i]).server = &cfg.servers[i];
+		multiplexer.add_fd(server_fds[i], POLLIN);
+	}
+}
+
+template <typename T>
+void Server::printPoolStats(const char* name, const ObjectPool<T>& pool)
+{
+	const typename ObjectPool<T>::Stats& st = pool.getStats();
+
+	std::cout << "Pool " << name << ": hits=" << st.hits << " misses=" << st.misses
+			  << " discarded=" << st.discarded << " free=" << pool.freeCount() << std::endl;
+}
+
 Server::~Server()
 {
 	std::cout << BOLD_ORANGE << "=== Shutting down server ===" << RES << std::endl;
 
-	// Nettoyer tous les CGI en cours
-	for (std::map<int, CgiProcess*>::iterator it = cgi_by_pipe_out.begin();
-		 it != cgi_by_pipe_out.end(); ++it)
+	// Nettoyer tous les CGI en cours (chaque CGI actif a encore son pipe_out)
+	for (size_t fd = 0; fd < slots.size(); fd++)
 	{
-		CgiProcess* cgi = it->second;
+		if (slots[fd].type != FD_CGI_OUT)
+			continue;
+		CgiProcess* cgi = slots[fd].cgi;
+		timers.cancel(cgi->timer);
 		if (cgi->pipe_in >= 0)
 			close(cgi->pipe_in);
 		if (cgi->pipe_out >= 0)
@@ -94,27 +158,19 @@ Server::~Server()
 			kill(cgi->pid, SIGKILL);
 			waitpid(cgi->pid, NULL, WNOHANG);  // Non-blocking reap
 		}
-		delete cgi;
-	}
-	cgi_by_pipe_in.clear();
-	cgi_by_pipe_out.clear();
-	cgi_by_client.clear();
-
-	// Fermer toutes les connexions clients
-	for (std::map<int, Connection*>::iterator it = clients.begin();
-		 it != clients.end(); ++it)
-	{
-		delete it->second;
+		cgi_pool.release(cgi);
 	}
-	clients.clear();
 
-	// Liberer tous les parsers HTTP
-	for (std::map<int, HttpRequestParser*>::iterator it = parsers.begin();
-		 it != parsers.end(); ++it)
+	// Fermer toutes les connexions clients et liberer leurs parsers HTTP
+	for (size_t fd = 0; fd < slots.size(); fd++)
 	{
-		delete it->second;
+		if (slots[fd].type != FD_CLIENT)
+			continue;
+		// Parser d'abord: il lit dans le recv_buffer de la Connection
+		parser_pool.release(slots[fd].parser);
+		conn_pool.release(slots[fd].conn);
 	}
-	parsers.clear();
+	slots.clear();
 
 	// Fermer tous les sockets serveurs
 	for (size_t i = 0; i < server_fds.size(); i++)
@@ -125,31 +181,61 @@ Server::~Server()
 		}
 	}
 	server_fds.clear();
-	fd_to_server.clear();
 
+	std::cout << "Connections: accepted=" << stats_accepted
+			  << " dropped=" << stats_dropped << std::endl;
+	printPoolStats("connections", conn_pool);
+	printPoolStats("parsers", parser_pool);
+	printPoolStats("cgi", cgi_pool);
+	if (file_cache.enabled())
+	{
+		const FileCache::Stats& fc = file_cache.getStats();
+		std::cout << "File cache: hits=" << fc.hits << " misses=" << fc.misses
+				  << " evictions=" << fc.evictions << " entries=" << file_cache.size()
+				  << " bytes=" << file_cache.bytes() << std::endl;
+	}
+	if (open_file_cache.enabled())
+	{
+		const OpenFileCache::Stats& oc = open_file_cache.getStats();
+		std::cout << "Open file cache: hits=" << oc.hits << " misses=" << oc.misses
+				  << " invalidations=" << oc.invalidations << " evictions=" << oc.evictions
+				  << " entries=" << open_file_cache.size() << std::endl;
+	}
 	std::cout << GREEN << "✓ " << RES << "Server stopped" << std::endl;
 }
 
+// running est deja a true depuis le constructeur: un stop() recu avant que
+// le thread du reactor n'atteigne run() n'est donc pas perdu
 void Server::run()
 {
-	running = true;
-
 	std::cout << std::endl << "Multi-client server running on ports: ";
 	for (size_t i = 0; i < server_fds.size(); i++) {
-		const ServerBlock* sb = fd_to_server[server_fds[i]];
+		const ServerBlock* sb = slots[server_fds[i]].server;
 		std::cout << GREEN << sb->port << RES;
 		if (i < server_fds.size() - 1) std::cout << ", ";
 	}
-	std::cout << std::endl << "(Ctrl+C to stop)\n" << std::endl;
+	std::cout << std::endl << "Event backend: " << BOLD << multiplexer.backend_name() << RES
+			  << (edge_triggered ? " (edge-triggered)" : "") << std::endl;
+	std::cout << "(Ctrl+C to stop)\n" << std::endl;
+
+	// Les PathUtils de ce thread passent par le cache de ce Server
+	OpenFileCache::install(&open_file_cache);
 
 	while (running)
 	{
-		// Attendre des evenements sur les fds surveilles (timeout 5s pour vérifier les timeouts)
-		std::vector<int> ready_fds = multiplexer.wait(5000);
+		// Attendre des evenements jusqu'a la prochaine deadline (client inactif ou CGI)
+		int timeout = timers.next_timeout(Clock::now_ms());
+		if (timeout < 0 || timeout > MAX_WAIT_MS)
+			timeout = MAX_WAIT_MS;
+		std::vector<int> ready_fds = multiplexer.wait(timeout);
+
+		// Une lecture de l'heure par iteration: timers, last_activity, Date
+		Clock::update();
+		// Fichiers modifies depuis (inotify): avant de servir les requetes
+		open_file_cache.sync();
 
-		// Vérifier les connexions inactives et les CGI timeouts
-		checkClientTimeouts();
-		checkCgiTimeouts();
+		// Fermer les connexions inactives et les CGI trop longs (seulement les timers echus)
+		expireTimers();
 
 		if (ready_fds.empty()) {
 			continue;
@@ -159,14 +245,15 @@ void Server::run()
 		for (size_t i = 0; i < ready_fds.size(); i++)
 		{
 			int fd = ready_fds[i];
+			FdType type = (static_cast<size_t>(fd) < slots.size()) ? slots[fd].type : FD_FREE;
 
 			// Verifier si c'est un server socket (nouvelle connexion)
-			if (isServerSocket(fd))
+			if (type == FD_LISTEN)
 			{
 				acceptNewClient(fd);
 			}
 			// Verifier si c'est un pipe CGI (stdin pour ecriture)
-			else if (cgi_by_pipe_in.find(fd) != cgi_by_pipe_in.end())
+			else if (type == FD_CGI_IN)
 			{
 				short revents = multiplexer.get_revents(fd);
 				if (revents & POLLOUT)
@@ -175,7 +262,7 @@ void Server::run()
 				}
 			}
 			// Verifier si c'est un pipe CGI (stdout pour lecture)
-			else if (cgi_by_pipe_out.find(fd) != cgi_by_pipe_out.end())
+			else if (type == FD_CGI_OUT)
 			{
 				short revents = multiplexer.get_revents(fd);
 				if (revents & (POLLIN | POLLHUP))
@@ -184,15 +271,31 @@ void Server::run()
 				}
 			}
 			// Sinon c'est un client socket
-			else if (clients.find(fd) != clients.end())
+			else if (type == FD_CLIENT && slots[fd].lingering)
+			{
+				if (multiplexer.get_revents(fd) & (POLLERR | POLLNVAL))
+					removeClient(fd);
+				else
+					handleLingeringRead(fd);
+			}
+			else if (type == FD_CLIENT)
 			{
 				short revents = multiplexer.get_revents(fd);
+
+				// io_uring: resultat d'un envoi soumis par armWrite()
+				ssize_t sent;
+				if (multiplexer.send_result(fd, sent))
+				{
+					handleSendDone(fd, sent);
+					if (slots[fd].type != FD_CLIENT || slots[fd].lingering)
+						continue;
+				}
 				// std::cout << "[DEBUG] Client fd=" << fd << " revents: "
 				// 		  << ((revents & POLLIN) ? "POLLIN " : "")
 				// 		  << ((revents & POLLOUT) ? "POLLOUT " : "")
 				// 		  << ((revents & POLLHUP) ? "POLLHUP " : "")
 				// 		  << ((revents & POLLERR) ? "POLLERR " : "")
-				// 		  << "pending_data=" << clients[fd]->has_pending_data() << std::endl;
+				// 		  << "pending_data=" << slots[fd].conn->has_pending_data() << std::endl;
 
 				// Verifier d'abord les erreurs poll (connexion fermee, erreur socket)
 				if (revents & (POLLERR | POLLNVAL))
@@ -210,7 +313,7 @@ void Server::run()
 					handleClientRead(fd);
 
 					// Verifier si le client a ete supprime pendant la lecture
-					if (clients.find(fd) == clients.end())
+					if (slots[fd].type != FD_CLIENT)
 					{
 						client_disconnected = true;
 					}
@@ -221,10 +324,10 @@ void Server::run()
 				if (!client_disconnected && (revents & POLLOUT))
 				{
 					// std::cout << "[DEBUG] POLLOUT ready for client fd=" << fd
-					// 		  << " send_buffer size=" << clients[fd]->send_buffer.size() << std::endl;
+					// 		  << " send_buffer size=" << slots[fd].conn->send_buffer.size() << std::endl;
 					handleClientWrite(fd);
 					// Verifier si client existe encore apres write
-					if (clients.find(fd) == clients.end())
+					if (slots[fd].type != FD_CLIENT)
 						continue;
 				}
 
@@ -232,7 +335,7 @@ void Server::run()
 				if (!client_disconnected && (revents & POLLHUP) && !(revents & POLLIN))
 				{
 					// Ne fermer que si on n'a plus rien a envoyer
-					if (!clients[fd]->has_pending_data())
+					if (!slots[fd].conn->has_pending_data())
 					{
 						removeClient(fd);
 						continue;
@@ -243,6 +346,7 @@ void Server::run()
 		}
 
 	}
+	OpenFileCache::install(NULL);
 }
 
 void Server::stop()
@@ -252,42 +356,82 @@ void Server::stop()
 
 bool Server::isServerSocket(int fd) const
 {
-	return (fd_to_server.find(fd) != fd_to_server.end());
+	return (fd >= 0 && static_cast<size_t>(fd) < slots.size() && slots[fd].type == FD_LISTEN);
 }
 
-void Server::acceptNewClient(int server_fd)
+Server::FdSlot& Server::slot(int fd)
 {
-	try {
-		int client_fd = socket_manager.accept_connection(server_fd);
-		Connection* conn = new Connection(client_fd);
-		clients[client_fd] = conn;
+	if (static_cast<size_t>(fd) >= slots.size())
+		slots.resize(fd + 1);
+	return (slots[fd]);
+}
 
-		// Stocker quel ServerBlock a accepté ce client
-		const ServerBlock* sb = fd_to_server.find(server_fd)->second;
-		client_to_server[client_fd] = sb;
+Server::FdSlot* Server::findSlot(int fd, FdType type)
+{
+	if (fd < 0 || static_cast<size_t>(fd) >= slots.size() || slots[fd].type != type)
+		return (NULL);
+	return (&slots[fd]);
+}
 
-		// Surveiller le client pour les donnees entrantes
-		multiplexer.add_fd(client_fd, POLLIN);
-		std::cout << GREEN << "✓ " << RES << "New client connected on port " << sb->port << ": "
-				  << "fd=" << client_fd << " -> (total clients: " << clients.size() << ")"
-				  << std::endl;
-	}
-	catch (const SocketManager::SocketException& e)
-	{
-		std::cerr << "✗ Error accepting client: " << e.what() << std::endl;
-	}
-	catch (const Connection::ConnectionException& e)
+void Server::releaseSlot(int fd)
+{
+	if (fd >= 0 && static_cast<size_t>(fd) < slots.size())
+		slots[fd] = FdSlot();
+}
+
+/*
+	Vide la file d'attente du socket d'ecoute: jusqu'a accept_batch connexions
+	par evenement (le reste sera signale au prochain wait(), le socket d'ecoute
+	est toujours en level-triggered). Une connexion qu'on n'arrive pas a
+	accepter ou a enregistrer est comptee dans stats_dropped.
+*/
+void Server::acceptNewClient(int server_fd)
+{
+	const ServerBlock* sb = slots[server_fd].server;
+
+	for (int i = 0; i < config->acceptBatch; i++)
 	{
-		std::cerr << "✗ Error creating connection: " << e.what() << std::endl;
+		int client_fd;
+		try {
+			client_fd = socket_manager.accept_connection(server_fd);
+		}
+		catch (const SocketManager::SocketException& e)
+		{
+			// EMFILE, ENOBUFS... : on reessaiera au prochain evenement
+			stats_dropped++;
+			std::cerr << "✗ Error accepting client: " << e.what() << std::endl;
+			return;
+		}
+		if (client_fd < 0)
+			return;	// File vide (ou prise par un autre worker/reactor)
+
+		Connection* conn = conn_pool.acquire();
+		conn->attach(client_fd);
+		try {
+			multiplexer.add_fd(client_fd, POLLIN, edge_triggered);
+		}
+		catch (const IOMultiplexer::MultiplexerException& e)
+		{
+			stats_dropped++;
+			std::cerr << "✗ Error registering client: " << e.what() << std::endl;
+			conn_pool.release(conn);
+			continue;
+		}
+		FdSlot& s = slot(client_fd);
+		s.type = FD_CLIENT;
+		s.conn = conn;
+		s.server = sb;	// ServerBlock qui a accepte ce client
+		conn->arm_idle_timeout(&timers, CLIENT_TIMEOUT_SECONDS * 1000ULL);
+		stats_accepted++;
 	}
 }
 
 void Server::handleClientRead(int fd)
 {
-	Connection* conn = clients[fd];
-	ssize_t n = conn->read_available();
+	Connection* conn = slots[fd].conn;
+	ssize_t n = conn->read_available(edge_triggered);
 
-	if (n > 0 || n == -2)
+	if (n > 0)
 	{
 		// Mettre à jour le timestamp d'activité
 		conn->update_activity();
@@ -298,10 +442,31 @@ void Server::handleClientRead(int fd)
 		// Traiter la requete HTTP avec le parser
 		processRequest(conn, fd);
 
-		// Activer POLLOUT si une reponse est prete
+		// EOF recu pendant le drain (edge-triggered): epoll ne le signalera plus,
+		// on ferme apres avoir envoye ce qui est pret
+		if (conn->peer_closed)
+		{
+			conn->should_close = true;
+			if (!conn->has_pending_data())
+			{
+				removeClient(fd);
+				return;
+			}
+		}
+
+		// Envoyer si une reponse est prete. Les requetes suivantes
+		// attendent dans recv_buffer: plus lu au-dela de maxIdleBuffered,
+		// responseSent() rearme POLLIN une fois la reponse envoyee
 		if (!conn->send_buffer.empty())
 		{
-			multiplexer.modify_fd(fd, POLLIN | POLLOUT);
+			short in = conn->recv_buffer.size() < Connection::maxIdleBuffered ? POLLIN : 0;
+			armWrite(fd, in);
+		}
+		// Drain plafonne (edge-triggered): EPOLL_CTL_MOD rearme le fd, la suite
+		// sera signalee au prochain wait() (sauf client en pause, voir updateCgiStdin)
+		else if (conn->drain_capped && !slots[fd].read_paused)
+		{
+			multiplexer.modify_fd(fd, POLLIN);
 		}
 	}
 	else if (n == 0)
@@ -312,7 +477,7 @@ void Server::handleClientRead(int fd)
 		{
 			// std::cout << "[DEBUG] Client half-closed but we have data to send" << std::endl;
 			// Desactiver POLLIN, garder POLLOUT pour envoyer la reponse
-			multiplexer.modify_fd(fd, POLLOUT);
+			armWrite(fd, 0);
 			conn->should_close = true;  // Fermer apres envoi
 		}
 		else
@@ -321,9 +486,6 @@ void Server::handleClientRead(int fd)
 			removeClient(fd);
 		}
 	}
-	// else if (n == -2) {
-	// 	conn->send_buffer = ResponseBuilder::build(HttpResponse(413, "Payload Too Large"), true);
-	// }
 	else
 	{
 		// Erreur de lecture - fermer la connexion silencieusement
@@ -334,7 +496,11 @@ void Server::handleClientRead(int fd)
 
 void Server::handleClientWrite(int fd)
 {
-	Connection* conn = clients[fd];
+	Connection* conn = slots[fd].conn;
+
+	// io_uring envoie deja la reponse: le resultat arrive avec un wait()
+	if (conn->send_in_flight)
+		return;
 
 	// std::cout << "[DEBUG] handleClientWrite fd=" << fd
 	// 		  << " has_pending=" << conn->has_pending_data()
@@ -343,8 +509,11 @@ void Server::handleClientWrite(int fd)
 
 	if (conn->has_pending_data())
 	{
-		ssize_t sent = conn->write_pending();
+		ssize_t sent = conn->write_pending(edge_triggered);
 		// std::cout << "[DEBUG] write_pending returned " << sent << std::endl;
+		// Un gros fichier vers un client lent n'est pas une connexion inactive
+		if (sent > 0)
+			conn->update_activity();
 
 		// if (sent > 0)
 		// {
@@ -362,100 +531,221 @@ void Server::handleClientWrite(int fd)
 
 		// Si tout a ete envoye
 		if (!conn->has_pending_data())
+			responseSent(fd);
+	}
+	else
+	{
+		// std::cout << "[DEBUG] No pending data for fd=" << fd << std::endl;
+		// Plus rien a envoyer, desactiver POLLOUT
+		multiplexer.modify_fd(fd, slots[fd].read_paused ? 0 : POLLIN);
+	}
+}
+
+/*
+	Reponse entierement envoyee: requete suivante deja recue (pipelining),
+	fermeture (Connection: close, erreur) ou attente de la suivante (keep-alive)
+*/
+void Server::responseSent(int fd)
+{
+	Connection* conn = slots[fd].conn;
+
+	// Pipelining: verifier si le parser a des donnees bufferisees (prochaine requete)
+	// IMPORTANT: faire ceci AVANT de fermer la connexion (meme si should_close)
+	// (ou requete terminee pendant l'envoi d'un "100 Continue")
+	// Pas apres une reponse d'erreur: la connexion se ferme, le reste
+	// de l'entree n'est plus une requete (voir processRequest)
+	HttpRequestParser* parser = slots[fd].parser;
+	if (parser != NULL && !slots[fd].closing
+		&& (parser->hasBufferedData() || parser->isDone() || parser->hasError()))
+	{
+		// std::cout << "[DEBUG] Pipelining: processing next buffered request" << std::endl;
+		processRequest(conn, fd);
+		// Verifier si client existe encore
+		if (slots[fd].type != FD_CLIENT)
+			return;
+		// Si une nouvelle reponse est prete, l'envoyer
+		if (!conn->send_buffer.empty())
 		{
-			// std::cout << "[DEBUG] All data sent for fd=" << fd << std::endl;
+			armWrite(fd, 0);
+			return;
+		}
+	}
 
-			// Pipelining: verifier si le parser a des donnees bufferisees (prochaine requete)
-			// IMPORTANT: faire ceci AVANT de fermer la connexion (meme si should_close)
-			std::map<int, HttpRequestParser*>::iterator parser_it = parsers.find(fd);
-			if (parser_it != parsers.end() && parser_it->second->hasBufferedData())
-			{
-				// std::cout << "[DEBUG] Pipelining: processing next buffered request" << std::endl;
-				processRequest(conn, fd);
-				// Verifier si client existe encore
-				if (clients.find(fd) == clients.end())
-					return;
-				// Si une nouvelle reponse est prete, activer POLLOUT
-				if (!conn->send_buffer.empty())
-				{
-					multiplexer.modify_fd(fd, POLLOUT);
-					return;
-				}
-			}
+	// Fermer si Connection: close etait demande (ou half-close).
+	// Reponse partie avant la fin du body (ou erreur du parser): le
+	// reste arrive encore
+	if (conn->should_close)
+	{
+		if ((slots[fd].answered_early || slots[fd].closing) && !conn->peer_closed)
+			startLingeringClose(fd);
+		else
+			removeClient(fd);
+		return;
+	}
 
-			// Fermer si Connection: close etait demande (ou half-close)
-			if (conn->should_close)
-			{
-				removeClient(fd);
-				return;
-			}
+	// Sinon garder la connexion (keep-alive), sauf lecture en pause (CGI en retard)
+	multiplexer.modify_fd(fd, slots[fd].read_paused ? 0 : POLLIN);
+}
 
-			// Sinon garder la connexion (keep-alive)
-			multiplexer.modify_fd(fd, POLLIN);
+/*
+	Reponse prete: avec io_uring elle part dans le io_uring_enter() du
+	prochain wait() (SENDMSG), sans attendre POLLOUT. Sinon (autre backend,
+	body fichier pour sendfile(), envoi deja en cours): POLLOUT comme avant.
+	in: POLLIN si on continue de lire le client pendant l'envoi, 0 sinon
+*/
+void Server::armWrite(int fd, short in)
+{
+	Connection* conn = slots[fd].conn;
+
+	if (multiplexer.supports_async_send())
+	{
+		struct msghdr* msg = conn->send_in_flight ? NULL : conn->prepare_send();
+		if (msg != NULL)
+			multiplexer.submit_send(fd, msg);
+		if (conn->send_in_flight)
+		{
+			multiplexer.modify_fd(fd, in);
+			return;
 		}
 	}
-	else
+	multiplexer.modify_fd(fd, in | POLLOUT);
+}
+
+/*
+	io_uring: resultat de l'envoi soumis par armWrite(). S'il reste quelque
+	chose (socket plein, ou rien n'est parti): suite au POLLOUT, par
+	handleClientWrite(), comme sans io_uring
+*/
+void Server::handleSendDone(int fd, ssize_t n)
+{
+	Connection* conn = slots[fd].conn;
+
+	if (conn->complete_send(n) < 0)
 	{
-		// std::cout << "[DEBUG] No pending data for fd=" << fd << std::endl;
-		// Plus rien a envoyer, desactiver POLLOUT
-		multiplexer.modify_fd(fd, POLLIN);
+		removeClient(fd);
+		return;
+	}
+	if (n > 0)
+		conn->update_activity();
+	if (conn->has_pending_data())
+	{
+		bool paused = slots[fd].read_paused || conn->recv_buffer.size() >= Connection::maxIdleBuffered;
+		multiplexer.modify_fd(fd, paused ? POLLOUT : (POLLIN | POLLOUT));
 	}
+	else
+		responseSent(fd);
 }
 
 void Server::removeClient(int fd)
 {
-	std::map<int, Connection*>::iterator it = clients.find(fd);
+	FdSlot* s = findSlot(fd, FD_CLIENT);
 
-	if (it != clients.end())
+	if (s != NULL)
 	{
 		// Cleanup any CGI running for this client
-		std::map<int, CgiProcess*>::iterator cgi_it = cgi_by_client.find(fd);
-		if (cgi_it != cgi_by_client.end())
+		if (s->cgi != NULL)
 		{
 			// std::cout << "[CGI] Client fd=" << fd << " disconnecting, cleaning up CGI" << std::endl;
-			cleanupCgi(cgi_it->second);
+			cleanupCgi(s->cgi);
+			s = &slots[fd];
 		}
 
 		multiplexer.remove_fd(fd);
-		delete it->second;
-		clients.erase(it);
 
-		// Supprimer aussi le parser HTTP associe
-		std::map<int, HttpRequestParser*>::iterator parser_it = parsers.find(fd);
-		if (parser_it != parsers.end())
-		{
-			delete parser_it->second;
-			parsers.erase(parser_it);
-		}
+		// Rendre le parser HTTP avant la Connection: il pointe sur son
+		// recv_buffer, detruit si le pool de connexions est plein
+		parser_pool.release(s->parser);
+		conn_pool.release(s->conn);
 
-		// Supprimer le mapping client -> server
-		client_to_server.erase(fd);
+		// Le slot redevient libre (ServerBlock, CGI...)
+		releaseSlot(fd);
 	}
 }
 
-void Server::processRequest(Connection* conn, int fd)
+/*
+	Reponse envoyee mais le client n'a pas fini d'envoyer sa requete (413, 405...
+	des les en-tetes, ou erreur du parser: 413 au milieu d'un body chunked,
+	tete trop longue...). close() avec des bytes non lus dans le socket envoie un
+	RST, que le client peut recevoir avant d'avoir lu notre reponse. On ferme
+	donc seulement l'ecriture (le client voit EOF apres la reponse) et on jette
+	ce qui arrive, jusqu'a son EOF, LINGER_MAX_BYTES ou LINGER_TIMEOUT_MS.
+*/
+void Server::startLingeringClose(int fd)
 {
-	// Catches casses where bytes read exceeds limit set in Connection.hpp
-	if (conn->totalBytesReceived > conn->maxRequestSize) {
-		HttpResponse resp(413, "Payload Too Large");
-		conn->send_buffer = ResponseBuilder::build(resp, true);
-		printNonSuccess(resp);
+	Connection* conn = slots[fd].conn;
+
+	if (shutdown(fd, SHUT_WR) < 0)
+	{
+		removeClient(fd);
 		return;
 	}
+	slots[fd].lingering = true;
+	slots[fd].linger_bytes = 0;
+	// Delai fixe: handleLingeringRead() ne repousse pas le timer
+	timers.schedule(conn->idle_timer, LINGER_TIMEOUT_MS);
+	multiplexer.modify_fd(fd, POLLIN);
+}
+
+void Server::handleLingeringRead(int fd)
+{
+	char	buf[16 * 1024];
+
+	// Jusqu'a ce que recv() echoue (edge-triggered), borne par LINGER_MAX_BYTES.
+	// On ne verifie JAMAIS errno apres recv() (interdit par le sujet): n < 0,
+	// on attend le prochain evenement (POLLERR si vraie erreur) ou le timer
+	while (true)
+	{
+		ssize_t n = recv(fd, buf, sizeof(buf), 0);
+		if (n < 0)
+			return;
+		if (n == 0)
+			break;
+		slots[fd].linger_bytes += n;
+		if (slots[fd].linger_bytes >= LINGER_MAX_BYTES)
+			break;
+	}
+	removeClient(fd);
+}
+
+void Server::processRequest(Connection* conn, int fd)
+{
+	// Reponse d'erreur deja prete: rien de ce qui arrive n'est parse
+	if (slots[fd].closing)
+		return;
 
 	// Creer un parser pour ce client si necessaire
-	if (parsers.find(fd) == parsers.end())
+	if (slots[fd].parser == NULL)
 	{
-		parsers[fd] = new HttpRequestParser();
+		slots[fd].parser = parser_pool.acquire();
+		slots[fd].parser->bind(&conn->recv_buffer);
+		// Limites des en-tetes du server block (large_client_header_buffers, max_headers)
+		const ServerBlock* block = slots[fd].server;
+		if (block != NULL)
+			slots[fd].parser->setHeaderLimits(block->headerLineMax, block->headerTotalMax, block->maxHeaders);
+		// Apres les en-tetes, le parser attend qu'on choisisse ou va le body
+		slots[fd].parser->waitForBodySink(true);
 		// std::cout << "  [fd=" << fd << "] Created HTTP parser" << std::endl;
 	}
 
-	HttpRequestParser* parser = parsers[fd];
+	HttpRequestParser* parser = slots[fd].parser;
+
+	// Le parser lit directement dans conn->recv_buffer (pas de copie)
+	parser->parse();
+	if (conn->send_buffer.empty() && parser->needsBodySink())
+	{
+		selectBodySink(fd);
+		parser->parse();
+	}
+
+	// Body streame vers le CGI: ecrire ce qui vient d'arriver. Le timeout du
+	// CGI repart a chaque progres (un long upload n'est pas un script bloque)
+	if (slots[fd].body_to_cgi && slots[fd].cgi != NULL)
+	{
+		CgiProcess* cgi = slots[fd].cgi;
+		updateCgiStdin(cgi);
+		timers.schedule(cgi->timer, cgi->timeout * 1000ULL);
+	}
 
-	// Envoyer les donnees au parser
-	// std::cout << BOLD_GOLD << conn->recv_buffer << RES << std::endl;
-	parser->feed(conn->recv_buffer);
-	conn->recv_buffer.clear();
 		// Prevent pipelining from overwriting the pending response
 	if (!conn->send_buffer.empty())
 		return;
@@ -474,66 +764,75 @@ void Server::processRequest(Connection* conn, int fd)
 
 		// resp.headers["Content-Length: "] = toStringSize(resp.body.size());//NICO DID THIS CHANGE
 
+		// Body incomplet: le CGI qui le recevait n'aura jamais la suite
+		if (slots[fd].body_to_cgi)
+		{
+			if (slots[fd].cgi != NULL)
+				cleanupCgi(slots[fd].cgi);
+			slots[fd].body_to_cgi = false;
+		}
 
-		// Toujours fermer connexion sur erreur
-		conn->send_buffer = ResponseBuilder::build(resp, true);
-				// IMPORTANT: reset parser also on error
-		if (parser->hasBufferedData())
-			parser->resetKeepBuffer();
-		else
-			parser->reset();
-
+		// Toujours fermer connexion sur erreur. Le parser reste en erreur:
+		// l'entree non consommee (tete trop longue, reste du body...) ne doit
+		// pas etre reprise comme une nouvelle requete
+		ResponseBuilder::build(conn->send_buffer, resp, true);
+		conn->should_close = true;
+		slots[fd].closing = true;
 		return;
 	}
 
 	// Verifier si la requete est complete
 	else if (parser->isDone())
 	{
+		// Body streame vers un CGI demarre apres les en-tetes: sa reponse
+		// vient de finishCgi() (deja envoyee si le script n'a pas tout lu).
+		// Idem si la reponse est partie des les en-tetes (selectBodySink)
+		if (slots[fd].body_to_cgi || slots[fd].answered_early)
+		{
+			slots[fd].body_to_cgi = false;
+			slots[fd].answered_early = false;
+			if (parser->hasBufferedData())
+				parser->resetKeepBuffer();
+			else
+				parser->reset();
+			// CGI deja termine: la requete suivante (pipelining) peut passer
+			if (slots[fd].cgi == NULL && parser->hasBufferedData())
+				processRequest(conn, fd);
+			return;
+		}
+
 		// Traiter la requete HTTP valide
 		const HttpRequest& req = parser->getRequest();
 
 		// Generer la reponse HTTP avec le bon ServerBlock
-		const ServerBlock* serverBlock = client_to_server[fd];
-		Router	requestHandler(*config, serverBlock);
+		const ServerBlock* serverBlock = slots[fd].server;
+		Router	requestHandler(*config, serverBlock, file_cache.enabled() ? &file_cache : NULL);
 		HttpResponse resp = requestHandler.buildResponse(req);
 
 		// Check if this is a CGI request that needs async execution
 		if (resp.isCgiPending)
 		{
 			// Verify client doesn't already have a CGI running
-			if (cgi_by_client.find(fd) != cgi_by_client.end())
+			if (slots[fd].cgi != NULL)
 			{
 				std::cerr << "[CGI] Client fd=" << fd << " already has CGI running" << std::endl;
 				HttpResponse errResp(503, "Service Unavailable");
 				errResp.body = "CGI already running for this client";
-				conn->send_buffer = ResponseBuilder::build(errResp, true);
+				ResponseBuilder::build(conn->send_buffer, errResp, true);
 			}
 			else
 			{
 				// Start CGI asynchronously
-				CgiProcess* cgi = CgiHandler::startCgi(req, resp.cgiScriptPath, fd);
+				CgiProcess* cgi = launchCgi(fd, req, resp.cgiScriptPath, parser->shouldCloseConnection());
 				if (cgi == NULL)
 				{
 					// CGI failed to start
 					HttpResponse errResp(500, "Internal Server Error");
 					errResp.body = "Failed to start CGI";
-					conn->send_buffer = ResponseBuilder::build(errResp, true);
+					ResponseBuilder::build(conn->send_buffer, errResp, true);
 				}
 				else
 				{
-					// Save connection close preference (HTTP/1.0 vs 1.1)
-					cgi->should_close = parser->shouldCloseConnection();
-
-					// Register CGI pipes in poll()
-					if (cgi->pipe_in >= 0)
-					{
-						multiplexer.add_fd(cgi->pipe_in, POLLOUT);
-						cgi_by_pipe_in[cgi->pipe_in] = cgi;
-					}
-					multiplexer.add_fd(cgi->pipe_out, POLLIN);
-					cgi_by_pipe_out[cgi->pipe_out] = cgi;
-					cgi_by_client[fd] = cgi;
-
 					// Don't send response yet - wait for CGI to complete
 					// Reset parser for next request
 					if (parser->hasBufferedData())
@@ -548,7 +847,13 @@ void Server::processRequest(Connection* conn, int fd)
 		{
 			// Normal response (not CGI)
 			bool closeConnection = parser->shouldCloseConnection();
-			conn->send_buffer = ResponseBuilder::build(resp, closeConnection);
+			ResponseBuilder::build(conn->send_buffer, resp, closeConnection);
+			// Fichier statique: send_buffer n'a que les en-tetes, le body part avec sendfile()
+			if (resp.bodyFd >= 0)
+				conn->send_file(resp.bodyFd, resp.bodyOffset, resp.bodyLength);
+			// File cache: send_buffer n'a que status line, Connection et Date
+			else if (!resp.prebuilt.empty())
+				conn->send_prebuilt(resp.prebuilt);
 			conn->should_close = closeConnection;  // Fermer apres envoi si demande
 
 			// std::cout	<< std::left << BOLD_BLACK << std::setw(16) << "[Server]" << RES << "  ~  (Connection: "
@@ -563,32 +868,138 @@ void Server::processRequest(Connection* conn, int fd)
 	}
 }
 
-void Server::checkClientTimeouts() {
-	time_t now = time(NULL);
-	std::vector<int> to_remove;
+/*
+	En-tetes lus, body pas encore: le Router decide ou il va (BodyPlan).
+	- upload (POST)  : ecrit dans le fichier au fil de l'eau
+	- CGI            : script demarre tout de suite, body sur son stdin
+	- reponse qui n'utilise pas le body (GET, DELETE...): jete
+	- erreur/redirection connue des les en-tetes (413 sur Content-Length,
+	  405, 404, 301...): reponse envoyee tout de suite, sans attendre le
+	  body. S'il n'est pas deja entierement arrive, la connexion est fermee
+	  apres la reponse (on ne lit pas 1 Go pour rien)
+	Si le fichier ou le CGI ne peut pas etre ouvert, le body est garde en
+	memoire: le Router repondra ensuite exactement comme avant (500, 503...).
+*/
+void Server::selectBodySink(int fd)
+{
+	HttpRequestParser* parser = slots[fd].parser;
+	const HttpRequest& req = parser->getRequest();
+	Router router(*config, slots[fd].server);
+	BodyPlan plan = router.planBody(req);
 
-	// Identifier les clients qui ont dépassé le timeout
-	for (std::map<int, Connection*>::iterator it = clients.begin();
-		 it != clients.end(); ++it) {
-		int fd = it->first;
-		Connection* conn = it->second;
+	if (plan.target == BodyPlan::BODY_CGI && slots[fd].cgi == NULL)
+	{
+		CgiProcess* cgi = launchCgi(fd, req, plan.path, parser->shouldCloseConnection());
+		if (cgi != NULL)
+		{
+			parser->streamBodyTo(&cgi->stdin_sink, plan.maxBodySize);
+			slots[fd].body_to_cgi = true;
+			sendContinue(fd);
+			return;
+		}
+	}
+	else if (plan.target == BodyPlan::BODY_UPLOAD_FILE)
+	{
+		if (parser->streamBodyToFile(plan.path, plan.maxBodySize))
+		{
+			sendContinue(fd);
+			return;
+		}
+	}
+	else if (plan.target == BodyPlan::BODY_DISCARD)
+	{
+		parser->discardBody(plan.maxBodySize);
+		sendContinue(fd);
+		return;
+	}
+	else if (plan.target == BodyPlan::BODY_REJECT)
+	{
+		// Le body deja recu est jete; s'il est complet, chemin normal (keep-alive)
+		parser->discardBody(static_cast<size_t>(-1));
+		parser->parse();
+		if (parser->isDone() || parser->hasError())
+			return;
 
-		// Ne pas timeout les clients qui ont un CGI en cours
-		if (cgi_by_client.find(fd) != cgi_by_client.end())
-			continue;
+		HttpResponse resp = router.buildResponse(req);
+		Connection* conn = slots[fd].conn;
+		ResponseBuilder::build(conn->send_buffer, resp, true);
+		conn->should_close = true;
+		slots[fd].answered_early = true;
+		return;
+	}
+	parser->keepBody(plan.maxBodySize);
+	sendContinue(fd);
+}
+
+/*
+	"Expect: 100-continue": le client attend notre feu vert avant d'envoyer
+	le body (curl: jusqu'a 1 s). Appele une fois le body accepte; une erreur
+	connue des en-tetes part a la place comme reponse finale (BODY_REJECT).
+	Inutile si le client a deja commence a envoyer le body.
+*/
+void Server::sendContinue(int fd)
+{
+	HttpRequestParser* parser = slots[fd].parser;
+	Connection* conn = slots[fd].conn;
+
+	if (!parser->getRequest().expectContinue || parser->hasBufferedData())
+		return;
+	conn->send_buffer = ResponseBuilder::continueResponse;
+}
 
-		if (now - conn->last_activity > CLIENT_TIMEOUT_SECONDS) {
-			std::cout	<< std::left << BOLD_ORANGE << std::setw(16) << "[TIMEOUT]"
-						<< RES << "  ~  Client fd=" << fd << " inactive for "
-						<< BOLD << (now - conn->last_activity) << RES << "s,"
-						<< RED << " closing connection" << RES << std::endl;
-			to_remove.push_back(fd);
+/*
+	Seuls les timers echus sont visites (pas de parcours de tous les clients).
+	On copie (kind, fd) avant d'agir: fermer un client peut liberer d'autres
+	objets, les pointeurs vers les TimerNode ne sont plus surs ensuite.
+*/
+void Server::expireTimers()
+{
+	std::vector<TimerNode*> expired;
+	timers.expire(Clock::now_ms(), expired);
+	if (expired.empty())
+		return;
+
+	std::vector<std::pair<int, int> > events;
+	for (size_t i = 0; i < expired.size(); ++i)
+		events.push_back(std::make_pair(expired[i]->kind, expired[i]->fd));
+
+	time_t now = Clock::now();
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		int fd = events[i].second;
+
+		if (events[i].first == TimerWheel::TIMER_CGI)
+		{
+			FdSlot* s = findSlot(fd, FD_CLIENT);
+			if (s == NULL || s->cgi == NULL)
+				continue;
+			CgiProcess* cgi = s->cgi;
+			std::cout	<< std::left << BOLD_ORANGE << std::setw(16) << "[CGI TIMEOUT]"
+						<< RES << "  ~  pid=" << cgi->pid << " timed out after "
+						<< BOLD << cgi->timeout << RES << "s" << std::endl;
+			cgi->timed_out = true;
+			cgi->state = CgiProcess::CGI_ERROR;
+			finishCgi(cgi);
+			continue;
 		}
-	}
 
-	// Fermer les connexions timeout (on ne peut pas modifier la map pendant l'itération)
-	for (size_t i = 0; i < to_remove.size(); ++i) {
-		removeClient(to_remove[i]);
+		FdSlot* s = findSlot(fd, FD_CLIENT);
+		if (s == NULL)
+			continue;
+		// Ne pas timeout les clients qui ont un CGI en cours
+		if (s->cgi != NULL)
+			continue;
+		// Fin du delai de lingering close: pas une inactivite
+		if (s->lingering)
+		{
+			removeClient(fd);
+			continue;
+		}
+		std::cout	<< std::left << BOLD_ORANGE << std::setw(16) << "[TIMEOUT]"
+					<< RES << "  ~  Client fd=" << fd << " inactive for "
+					<< BOLD << (now - s->conn->last_activity) << RES << "s,"
+					<< RED << " closing connection" << RES << std::endl;
+		removeClient(fd);
 	}
 }
 
@@ -598,17 +1009,102 @@ void Server::checkClientTimeouts() {
 
 bool Server::isCgiPipe(int fd) const
 {
-	return (cgi_by_pipe_in.find(fd) != cgi_by_pipe_in.end() ||
-			cgi_by_pipe_out.find(fd) != cgi_by_pipe_out.end());
+	if (fd < 0 || static_cast<size_t>(fd) >= slots.size())
+		return (false);
+	return (slots[fd].type == FD_CGI_IN || slots[fd].type == FD_CGI_OUT);
+}
+
+/*
+	Demarre le CGI et enregistre ses pipes. pipe_in n'est surveille (POLLOUT)
+	que si des bytes du body attendent: un body streame arrive plus tard.
+*/
+CgiProcess* Server::launchCgi(int fd, const HttpRequest& req, const std::string& script_path,
+							  bool should_close)
+{
+	CgiProcess* pooled = cgi_pool.acquire();
+	CgiProcess* cgi = CgiHandler::startCgi(req, script_path, fd, "", 10, pooled);
+	if (cgi == NULL)
+	{
+		cgi_pool.release(pooled);
+		return NULL;
+	}
+
+	// Save connection close preference (HTTP/1.0 vs 1.1)
+	cgi->should_close = should_close;
+
+	// Register CGI pipes in poll()
+	if (cgi->pipe_in >= 0)
+	{
+		cgi->stdin_armed = cgi->hasBodyToWrite();
+		multiplexer.add_fd(cgi->pipe_in, cgi->stdin_armed ? POLLOUT : 0);
+		slot(cgi->pipe_in).type = FD_CGI_IN;
+		slot(cgi->pipe_in).cgi = cgi;
+	}
+	multiplexer.add_fd(cgi->pipe_out, POLLIN);
+	slot(cgi->pipe_out).type = FD_CGI_OUT;
+	slot(cgi->pipe_out).cgi = cgi;
+	slots[fd].cgi = cgi;
+
+	// Le client attend le CGI: seul le timeout CGI compte
+	// (finishCgi() rearme le timeout d'inactivite)
+	timers.cancel(slots[fd].conn->idle_timer);
+	cgi->timer.kind = TimerWheel::TIMER_CGI;
+	cgi->timer.fd = fd;
+	timers.schedule(cgi->timer, cgi->timeout * 1000ULL);
+	return cgi;
+}
+
+/*
+	Apres chaque progres du body (recu du client ou ecrit dans le pipe):
+	- pipe_in surveille en POLLOUT seulement si des bytes attendent
+	- tout ecrit et body complet: stdin ferme (EOF pour le script)
+	- plus de CGI_STDIN_BACKLOG bytes en retard: le client n'est plus lu,
+	  la memoire d'un gros upload reste bornee
+*/
+void Server::updateCgiStdin(CgiProcess* cgi)
+{
+	if (cgi->pipe_in >= 0)
+	{
+		if (!cgi->hasBodyToWrite() && cgi->body_complete)
+			closeCgiStdin(cgi);
+		else if (cgi->hasBodyToWrite() != cgi->stdin_armed)
+		{
+			cgi->stdin_armed = cgi->hasBodyToWrite();
+			multiplexer.modify_fd(cgi->pipe_in, cgi->stdin_armed ? POLLOUT : 0);
+		}
+	}
+
+	FdSlot* client = findSlot(cgi->client_fd, FD_CLIENT);
+	if (client == NULL)
+		return;
+	bool backlog = cgi->pipe_in >= 0 && cgi->body.size() - cgi->body_written > CGI_STDIN_BACKLOG;
+	if (backlog != client->read_paused)
+	{
+		// Une reponse en cours d'envoi (100 Continue) garde son POLLOUT
+		short out = (client->conn->has_pending_data() && !client->conn->send_in_flight) ? POLLOUT : 0;
+		client->read_paused = backlog;
+		multiplexer.modify_fd(cgi->client_fd, backlog ? out : (POLLIN | out));
+	}
+}
+
+void Server::closeCgiStdin(CgiProcess* cgi)
+{
+	multiplexer.remove_fd(cgi->pipe_in);
+	close(cgi->pipe_in);
+	releaseSlot(cgi->pipe_in);
+	cgi->pipe_in = -1;
+	cgi->stdin_armed = false;
+	cgi->state = CgiProcess::CGI_READING_OUTPUT;
+	// std::cout << "[CGI] Finished writing body, now reading output" << std::endl;
 }
 
 void Server::handleCgiWrite(int pipe_fd)
 {
-	std::map<int, CgiProcess*>::iterator it = cgi_by_pipe_in.find(pipe_fd);
-	if (it == cgi_by_pipe_in.end())
+	FdSlot* s = findSlot(pipe_fd, FD_CGI_IN);
+	if (s == NULL)
 		return;
 
-	CgiProcess* cgi = it->second;
+	CgiProcess* cgi = s->cgi;
 
 	// Write body to CGI stdin (one write per poll event)
 	if (cgi->hasBodyToWrite())
@@ -633,24 +1129,17 @@ void Server::handleCgiWrite(int pipe_fd)
 	}
 
 	// If all body written, close pipe_in and switch to reading
-	if (!cgi->hasBodyToWrite())
-	{
-		multiplexer.remove_fd(pipe_fd);
-		close(pipe_fd);
-		cgi_by_pipe_in.erase(pipe_fd);
-		cgi->pipe_in = -1;
-		cgi->state = CgiProcess::CGI_READING_OUTPUT;
-		// std::cout << "[CGI] Finished writing body, now reading output" << std::endl;
-	}
+	// (streamed body: wait for more, resume reading the client)
+	updateCgiStdin(cgi);
 }
 
 void Server::handleCgiRead(int pipe_fd)
 {
-	std::map<int, CgiProcess*>::iterator it = cgi_by_pipe_out.find(pipe_fd);
-	if (it == cgi_by_pipe_out.end())
+	FdSlot* s = findSlot(pipe_fd, FD_CGI_OUT);
+	if (s == NULL)
 		return;
 
-	CgiProcess* cgi = it->second;
+	CgiProcess* cgi = s->cgi;
 	char buffer[4096];
 
 	// Read from CGI stdout (one read per poll event)
@@ -680,45 +1169,20 @@ void Server::handleCgiRead(int pipe_fd)
 	}
 }
 
-void Server::checkCgiTimeouts()
-{
-	std::vector<CgiProcess*> to_cleanup;
-
-	// Check all active CGI processes
-	for (std::map<int, CgiProcess*>::iterator it = cgi_by_pipe_out.begin();
-		 it != cgi_by_pipe_out.end(); ++it)
-	{
-		CgiProcess* cgi = it->second;
-		if (cgi->isTimedOut())
-		{
-			std::cout	<< std::left << BOLD_ORANGE << std::setw(16) << "[CGI TIMEOUT]"
-						<< RES << "  ~  pid=" << cgi->pid << " timed out after "
-						<< BOLD << cgi->timeout << RES << "s" << std::endl;
-			cgi->state = CgiProcess::CGI_ERROR;
-			to_cleanup.push_back(cgi);
-		}
-	}
-
-	// Cleanup timed out CGIs
-	for (size_t i = 0; i < to_cleanup.size(); ++i)
-	{
-		finishCgi(to_cleanup[i]);
-	}
-}
-
 void Server::finishCgi(CgiProcess* cgi)
 {
 	int client_fd = cgi->client_fd;
 
 	// Check if client still exists
-	if (clients.find(client_fd) == clients.end())
+	FdSlot* client = findSlot(client_fd, FD_CLIENT);
+	if (client == NULL)
 	{
 		std::cerr << "[CGI] Client fd=" << client_fd << " disconnected, discarding CGI output" << std::endl;
 		cleanupCgi(cgi);
 		return;
 	}
 
-	Connection* conn = clients[client_fd];
+	Connection* conn = client->conn;
 	HttpResponse resp(500, "Internal Server Error");
 
 	if (cgi->state == CgiProcess::CGI_DONE)
@@ -779,10 +1243,10 @@ void Server::finishCgi(CgiProcess* cgi)
 	}
 
 	// Send response to client (respect HTTP/1.0 vs 1.1 connection handling)
-	conn->send_buffer = ResponseBuilder::build(resp, cgi->should_close);
+	ResponseBuilder::build(conn->send_buffer, resp, cgi->should_close);
 	conn->should_close = cgi->should_close;
 	conn->update_activity();  // Reset timeout pour laisser le temps d'envoyer la reponse
-	multiplexer.modify_fd(client_fd, POLLIN | POLLOUT);
+	armWrite(client_fd, POLLIN);
 	// std::cout << "[DEBUG] finishCgi: set POLLOUT for client_fd=" << client_fd
 	// 		  << " send_buffer size=" << conn->send_buffer.size()
 	// 		  << " should_close=" << cgi->should_close << std::endl;
@@ -797,20 +1261,31 @@ void Server::finishCgi(CgiProcess* cgi)
 
 void Server::cleanupCgi(CgiProcess* cgi)
 {
-	// Remove from maps
+	timers.cancel(cgi->timer);
+
+	// Liberer les slots des pipes et detacher le CGI du client
 	if (cgi->pipe_in >= 0)
 	{
 		multiplexer.remove_fd(cgi->pipe_in);
-		cgi_by_pipe_in.erase(cgi->pipe_in);
+		releaseSlot(cgi->pipe_in);
 		close(cgi->pipe_in);
 	}
 	if (cgi->pipe_out >= 0)
 	{
 		multiplexer.remove_fd(cgi->pipe_out);
-		cgi_by_pipe_out.erase(cgi->pipe_out);
+		releaseSlot(cgi->pipe_out);
 		close(cgi->pipe_out);
 	}
-	cgi_by_client.erase(cgi->client_fd);
+	FdSlot* client = findSlot(cgi->client_fd, FD_CLIENT);
+	if (client != NULL && client->cgi == cgi)
+	{
+		client->cgi = NULL;
+		client->read_paused = false;
+		// Body encore en route vers ce CGI (fini avant de tout lire, timeout):
+		// la suite est lue puis jetee, stdin_sink retourne au pool
+		if (client->body_to_cgi && client->parser != NULL)
+			client->parser->discardBody(static_cast<size_t>(-1));
+	}
 
 	// Kill process if still running (non-blocking only)
 	if (cgi->pid > 0)
@@ -826,5 +1301,5 @@ void Server::cleanupCgi(CgiProcess* cgi)
 		}
 	}
 
-	delete cgi;
+	cgi_pool.release(cgi);
 }
@@ -26,13 +26,23 @@ int SocketManager::create_socket()
 	return (fd);
 }
 
-void SocketManager::configure_socket(int fd)
+void SocketManager::configure_socket(int fd, bool reuse_port)
 {
 	int opt = 1;
 	if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
 	{
 		throw SocketException("setsockopt(SO_REUSEADDR) failed: " + std::string(strerror(errno)));
 	}
+	if (!reuse_port)
+		return;
+#ifdef SO_REUSEPORT
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+	{
+		throw SocketException("setsockopt(SO_REUSEPORT) failed: " + std::string(strerror(errno)));
+	}
+#else
+	throw SocketException("SO_REUSEPORT is not supported on this platform");
+#endif
 }
 
 void SocketManager::bind_socket(int fd, int port)
@@ -60,12 +70,12 @@ void SocketManager::start_listening(int fd, int backlog)
 	}
 }
 
-int SocketManager::create_server(int port, int backlog)
+int SocketManager::create_server(int port, int backlog, bool reuse_port)
 {
 	int fd = create_socket();
 
 	try {
-		configure_socket(fd);
+		configure_socket(fd, reuse_port);
 		bind_socket(fd, port);
 		start_listening(fd, backlog);
 		// Set listening socket to non-blocking (subject requirement)
@@ -88,9 +98,24 @@ int SocketManager::accept_connection(int server_fd)
 	socklen_t len = sizeof(client_addr);
 	std::memset(&client_addr, 0, sizeof(client_addr));
 
+#ifdef __linux__
+	// accept4: O_NONBLOCK + FD_CLOEXEC dans le meme syscall (pas de fcntl apres)
+	int client_fd = accept4(server_fd, (struct sockaddr*)&client_addr, &len,
+							SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
 	int client_fd = accept(server_fd, (struct sockaddr*)&client_addr, &len);
+	if (client_fd >= 0 && (fcntl(client_fd, F_SETFL, O_NONBLOCK) < 0
+						   || fcntl(client_fd, F_SETFD, FD_CLOEXEC) < 0))
+	{
+		close(client_fd);
+		throw SocketException("fcntl() failed on client socket: " + std::string(strerror(errno)));
+	}
+#endif
 
 	if (client_fd < 0) {
+		// File vide: un autre processus partageant le socket a ete plus rapide
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return (-1);
 		throw SocketException("accept() failed: " + std::string(strerror(errno)));
 	}
 
@@ -0,0 +1,114 @@
+#include "network/TimerWheel.hpp"
+#include "network/Clock.hpp"
+
+TimerWheel::TimerWheel()
+	: current_tick(Clock::now_ms() / TICK_MS), count(0)
+{
+	for (unsigned i = 0; i < SLOTS; i++)
+	{
+		slots[i].prev = &slots[i];
+		slots[i].next = &slots[i];
+	}
+}
+
+// Les noeuds appartiennent a leurs objets: on les detache juste
+TimerWheel::~TimerWheel()
+{
+	for (unsigned i = 0; i < SLOTS; i++)
+	{
+		while (slots[i].next != &slots[i])
+			unlink(*slots[i].next);
+	}
+}
+
+void TimerWheel::link(TimerNode& head, TimerNode& node)
+{
+	node.prev = head.prev;
+	node.next = &head;
+	head.prev->next = &node;
+	head.prev = &node;
+	count++;
+}
+
+void TimerWheel::unlink(TimerNode& node)
+{
+	node.prev->next = node.next;
+	node.next->prev = node.prev;
+	node.prev = NULL;
+	node.next = NULL;
+	count--;
+}
+
+void TimerWheel::schedule(TimerNode& node, unsigned long long delay_ms)
+{
+	if (node.armed())
+		unlink(node);
+
+	node.expires = Clock::now_ms() + delay_ms;
+
+	// Bucket = tick arrondi au superieur: quand expire() l'atteint, la deadline est passee
+	unsigned long long tick = (node.expires + TICK_MS - 1) / TICK_MS;
+	if (tick <= current_tick)
+		tick = current_tick + 1;
+	link(slots[tick % SLOTS], node);
+}
+
+void TimerWheel::cancel(TimerNode& node)
+{
+	if (node.armed())
+		unlink(node);
+}
+
+int TimerWheel::next_timeout(unsigned long long now) const
+{
+	if (count == 0)
+		return (-1);
+
+	for (unsigned i = 1; i <= SLOTS; i++)
+	{
+		unsigned long long tick = current_tick + i;
+		const TimerNode& head = slots[tick % SLOTS];
+		if (head.next == &head)
+			continue;
+		// Le bucket peut ne contenir que des timers d'un tour suivant:
+		// on se reveille un peu tot, expire() n'y touchera pas
+		unsigned long long at = tick * TICK_MS;
+		return (at <= now ? 0 : static_cast<int>(at - now));
+	}
+	return (-1);
+}
+
+void TimerWheel::expire(unsigned long long now, std::vector<TimerNode*>& expired)
+{
+	unsigned long long target = now / TICK_MS;
+
+	if (target <= current_tick)
+		return;
+
+	// Plus d'un tour complet ecoule: chaque bucket n'est visite qu'une fois
+	unsigned long long first = current_tick + 1;
+	if (target - current_tick > SLOTS)
+		first = target - SLOTS + 1;
+
+	for (unsigned long long tick = first; tick <= target; tick++)
+	{
+		TimerNode& head = slots[tick % SLOTS];
+		TimerNode* node = head.next;
+		while (node != &head)
+		{
+			TimerNode* next = node->next;
+			if (node->expires <= now)
+			{
+				unlink(*node);
+				expired.push_back(node);
+			}
+			node = next;
+		}
+	}
+	current_tick = target;
+}
+
+size_t TimerWheel::size() const
+{
+	return (count);
+}
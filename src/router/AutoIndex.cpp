@@ -4,7 +4,7 @@
 #include <dirent.h>                // opendir(), readdir(), closedir(), DIR, dirent
 #include <sys/stat.h>              // stat(), struct stat, S_ISDIR, S_ISREG
 #include <sstream>                 // std::ostringstream
-#include <ctime>                   // std::localtime, std::strftime, time_t
+#include <ctime>                   // localtime_r, std::strftime, time_t
 // ----------------------------------------------------------------------------
 // INTERNAL HELPERS (file-private)
 // ----------------------------------------------------------------------------
@@ -46,7 +46,8 @@ static std::string ensureTrailingSlash(const std::string& p)
 static std::string formatTime(time_t t)
 {
 	char buf[64];
-	std::tm* tmv = std::localtime(&t);
+	std::tm tmbuf;
+	std::tm* tmv = localtime_r(&t, &tmbuf);
 	if (!tmv)
 		return ("");
 	std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tmv);
@@ -0,0 +1,139 @@
+#include "router/FileCache.hpp"
+#include "http/Mime.hpp"
+#include "http/ResponseBuilder.hpp"
+#include "http/Status.hpp"
+#include "network/Clock.hpp"
+#include <sstream>
+#include <unistd.h>
+
+FileCache::FileCache(size_t max_bytes, size_t max_entry)
+	: lru(), index(), max_bytes(max_bytes),
+	  max_entry(max_entry < max_bytes ? max_entry : max_bytes), used(0)
+{
+	stats.hits = 0;
+	stats.misses = 0;
+	stats.evictions = 0;
+}
+
+const FileCache::Entry*	FileCache::lookup(const std::string& path, const struct stat& st)
+{
+	EntryIndex::iterator	it = index.find(path);
+
+	if (it == index.end())
+	{
+		stats.misses++;
+		return (NULL);
+	}
+	// Modifie, remplace ou chmod depuis la lecture: relu par l'appelant
+	if (!sameFile(it->second->st, st))
+	{
+		erase(it);
+		stats.misses++;
+		return (NULL);
+	}
+	stats.hits++;
+	lru.splice(lru.begin(), lru, it->second);	// O(1), l'iterateur reste valide
+	return (&*it->second);
+}
+
+const FileCache::Entry*	FileCache::insert(const std::string& path, int fd, const struct stat& st)
+{
+	if (!enabled() || !S_ISREG(st.st_mode) || static_cast<size_t>(st.st_size) > max_entry)
+		return (NULL);
+	// Modifie dans la seconde: peut-etre encore en cours d'ecriture, et son
+	// ETag est faible (makeETag()). Mis en cache a une requete suivante
+	if (st.st_mtime >= Clock::now())
+		return (NULL);
+
+	EntryIndex::iterator	old = index.find(path);
+	if (old != index.end())
+		erase(old);
+
+	// En-tetes serialises une fois, le fichier lu juste apres (pas de copie du body)
+	HttpResponse	resp(200, reasonPhrase(200));
+	std::string		bytes;
+	size_t			size = static_cast<size_t>(st.st_size);
+	size_t			done = 0;
+
+	resp.headers["Content-Type"] = Mime::fromPath(path);
+	resp.headers["ETag"] = makeETag(st);
+	resp.headers["Last-Modified"] = makeLastModified(st);
+	resp.bodyFd = fd;
+	resp.bodyLength = size;
+	ResponseBuilder::buildPrebuilt(bytes, resp);
+
+	size_t	head = bytes.size();
+	bytes.resize(head + size);
+	while (done < size)
+	{
+		// pread(): la position du fd ne bouge pas (sendfile() si on abandonne)
+		ssize_t	n = pread(fd, &bytes[head + done], size - done, static_cast<off_t>(done));
+		if (n <= 0)
+			return (NULL);	// erreur ou fichier tronque pendant la lecture
+		done += n;
+	}
+
+	lru.push_front(Entry());
+	Entry&	e = lru.front();
+	e.path = path;
+	e.response = SharedBuffer::adopt(bytes);
+	e.bodyOffset = head;
+	e.contentType = resp.headers["Content-Type"];
+	e.etag = resp.headers["ETag"];
+	e.lastModified = resp.headers["Last-Modified"];
+	e.st = st;
+
+	// LRU: libere la place depuis la fin de la liste (jamais e, en tete)
+	size_t	needed = cost(e);
+	while (&lru.back() != &e && used + needed > max_bytes)
+	{
+		erase(index.find(lru.back().path));
+		stats.evictions++;
+	}
+	index[path] = lru.begin();
+	used += needed;
+	return (&e);
+}
+
+std::string	FileCache::makeETag(const struct stat& st)
+{
+	std::ostringstream	oss;
+
+	if (st.st_mtime >= Clock::now())
+		oss << "W/";
+	oss << '"' << std::hex << static_cast<unsigned long>(st.st_ino)
+		<< '-' << static_cast<unsigned long>(st.st_mtime)
+		<< '-' << static_cast<unsigned long>(st.st_size) << '"';
+	return (oss.str());
+}
+
+std::string	FileCache::makeLastModified(const struct stat& st)
+{
+	char	date[Clock::HTTP_DATE_LEN + 1];
+
+	if (!Clock::formatHttpDate(st.st_mtime, date))
+		return ("");
+	return (std::string(date, Clock::HTTP_DATE_LEN));
+}
+
+void	FileCache::erase(EntryIndex::iterator it)
+{
+	used -= cost(*it->second);
+	lru.erase(it->second);
+	index.erase(it);
+}
+
+// Bytes counted against max_bytes (the body dominates)
+size_t	FileCache::cost(const Entry& e)
+{
+	return (e.response.size() + e.path.size() + e.contentType.size() + e.etag.size()
+		+ e.lastModified.size());
+}
+
+bool	FileCache::sameFile(const struct stat& a, const struct stat& b)
+{
+	return (a.st_ino == b.st_ino && a.st_dev == b.st_dev
+		&& a.st_size == b.st_size
+		&& a.st_mtim.tv_sec == b.st_mtim.tv_sec && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec
+		&& a.st_ctim.tv_sec == b.st_ctim.tv_sec && a.st_ctim.tv_nsec == b.st_ctim.tv_nsec);
+}
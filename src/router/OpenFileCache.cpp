@@ -0,0 +1,286 @@
+#include "router/OpenFileCache.hpp"
+#include "network/Clock.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+// Cache du reactor de ce thread (worker_threads: un Server par thread)
+static __thread OpenFileCache*	t_current = NULL;
+
+// Everything that can change what stat()/access()/open() return for a child
+static const uint32_t	WATCH_MASK = IN_ATTRIB | IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE
+	| IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+// "www/assets/css/style.css" -> "www/assets/css", "www/pages/" -> "www"
+static std::string	parentDir(const std::string& path)
+{
+	size_t	end = path.find_last_not_of('/');
+
+	if (end == std::string::npos)
+		return ("/");
+	size_t	slash = path.rfind('/', end);
+	if (slash == std::string::npos)
+		return (".");
+	if (slash == 0)
+		return ("/");
+	return (path.substr(0, slash));
+}
+
+static bool	sameFile(const struct stat& a, const struct stat& b)
+{
+	return (a.st_ino == b.st_ino && a.st_dev == b.st_dev && a.st_size == b.st_size
+		&& a.st_mtim.tv_sec == b.st_mtim.tv_sec && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec
+		&& a.st_ctim.tv_sec == b.st_ctim.tv_sec && a.st_ctim.tv_nsec == b.st_ctim.tv_nsec);
+}
+
+OpenFileCache::OpenFileCache(size_t max_entries, unsigned valid_sec)
+	: lru(), index(), watches(), max_entries(max_entries),
+	  valid_ms(static_cast<unsigned long long>(valid_sec) * 1000ULL), inotify_fd(-1)
+{
+	stats.hits = 0;
+	stats.misses = 0;
+	stats.invalidations = 0;
+	stats.evictions = 0;
+	// Pas d'inotify (limite atteinte...): le TTL seul borne les donnees perimees
+	if (enabled())
+		inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+OpenFileCache::~OpenFileCache()
+{
+	if (t_current == this)
+		t_current = NULL;
+	clear();
+	if (inotify_fd >= 0)
+		close(inotify_fd);
+}
+
+void	OpenFileCache::install(OpenFileCache* cache)
+{
+	t_current = (cache != NULL && cache->enabled()) ? cache : NULL;
+}
+
+OpenFileCache*	OpenFileCache::current()
+{
+	return (t_current);
+}
+
+/*
+	Entry of path, stat() done at most once per `valid` seconds. An expired
+	entry is refreshed in place: its fd is kept if the file did not change.
+*/
+OpenFileCache::Entry*	OpenFileCache::lookup(const std::string& path)
+{
+	unsigned long long		now = Clock::now_ms();
+	EntryIndex::iterator	it = index.find(path);
+
+	if (it != index.end())
+	{
+		Entry&	e = *it->second;
+
+		lru.splice(lru.begin(), lru, it->second);
+		if (now - e.checked_ms < valid_ms)
+		{
+			stats.hits++;
+			return (&e);
+		}
+		stats.misses++;
+
+		struct stat	st;
+		bool		ok = (::stat(path.c_str(), &st) == 0);
+		if (!ok || !e.ok || !sameFile(e.st, st))
+		{
+			if (e.fd >= 0)
+				close(e.fd);
+			e.fd = -1;
+		}
+		e.ok = ok;
+		e.st = st;
+		e.access_known = 0;
+		e.access_ok = 0;
+		e.checked_ms = now;
+		if (e.wd < 0)
+			watch(e);
+		return (&e);
+	}
+
+	stats.misses++;
+	while (!lru.empty() && index.size() >= max_entries)
+	{
+		erase(index.find(lru.back().path));
+		stats.evictions++;
+	}
+	lru.push_front(Entry());
+	Entry&	e = lru.front();
+	e.path = path;
+	e.ok = (::stat(path.c_str(), &e.st) == 0);
+	e.fd = -1;
+	e.access_known = 0;
+	e.access_ok = 0;
+	e.checked_ms = now;
+	e.wd = -1;
+	index[path] = lru.begin();
+	watch(e);
+	return (&e);
+}
+
+bool	OpenFileCache::stat(const std::string& path, struct stat& st)
+{
+	Entry*	e = lookup(path);
+
+	if (e->ok)
+		st = e->st;
+	return (e->ok);
+}
+
+bool	OpenFileCache::access(const std::string& path, int mode)
+{
+	static const int	bits[] = {R_OK, W_OK, X_OK};
+	Entry*				e = lookup(path);
+
+	if (!e->ok)
+		return (false);
+	// access() une fois par bit demande, tant que l'entree est valide
+	for (size_t i = 0; i < sizeof(bits) / sizeof(bits[0]); ++i)
+	{
+		if (!(mode & bits[i]) || (e->access_known & bits[i]))
+			continue ;
+		if (::access(path.c_str(), bits[i]) == 0)
+			e->access_ok |= bits[i];
+		e->access_known |= bits[i];
+	}
+	return ((e->access_ok & mode) == mode);
+}
+
+int	OpenFileCache::open(const std::string& path, struct stat& st)
+{
+	Entry*	e = lookup(path);
+
+	// Fichiers reguliers seulement (open() d'une FIFO bloquerait)
+	if (!e->ok || !S_ISREG(e->st.st_mode))
+		return (-1);
+	if (e->fd < 0)
+	{
+		e->fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (e->fd < 0)
+			return (-1);
+	}
+	// Copie pour l'appelant (la Connection la ferme apres sendfile())
+	int	fd = fcntl(e->fd, F_DUPFD_CLOEXEC, 0);
+	if (fd >= 0)
+		st = e->st;
+	return (fd);
+}
+
+void	OpenFileCache::invalidate(const std::string& path)
+{
+	EntryIndex::iterator	it = index.find(path);
+
+	if (it == index.end())
+		return ;
+	erase(it);
+	stats.invalidations++;
+}
+
+void	OpenFileCache::sync()
+{
+	// Buffer aligne pour struct inotify_event
+	union {
+		struct inotify_event	ev;
+		char					buf[4096];
+	}	u;
+
+	if (inotify_fd < 0)
+		return ;
+	while (true)
+	{
+		ssize_t	n = read(inotify_fd, u.buf, sizeof(u.buf));
+		if (n <= 0)
+			break ;	// plus d'evenements (fd non-bloquant)
+		for (ssize_t off = 0; off < n; )
+		{
+			const struct inotify_event*	ev = reinterpret_cast<const struct inotify_event*>(u.buf + off);
+
+			if (ev->mask & IN_Q_OVERFLOW)
+				clear();	// evenements perdus: on ne sait plus quoi invalider
+			else
+				dropWatch(ev->wd, (ev->mask & IN_IGNORED) != 0);
+			off += sizeof(struct inotify_event) + ev->len;
+		}
+	}
+}
+
+// Watch on the parent directory of e (shared by all the entries of that directory)
+void	OpenFileCache::watch(Entry& e)
+{
+	if (inotify_fd < 0)
+		return ;
+	int	wd = inotify_add_watch(inotify_fd, parentDir(e.path).c_str(), WATCH_MASK);
+	if (wd < 0)
+		return ;	// dossier absent ou limite de watches: TTL seul
+	watches[wd].insert(e.path);
+	e.wd = wd;
+}
+
+void	OpenFileCache::erase(EntryIndex::iterator it)
+{
+	Entry&	e = *it->second;
+
+	if (e.fd >= 0)
+		close(e.fd);
+	if (e.wd >= 0)
+	{
+		WatchMap::iterator	w = watches.find(e.wd);
+		if (w != watches.end())
+		{
+			w->second.erase(e.path);
+			if (w->second.empty())
+			{
+				inotify_rm_watch(inotify_fd, e.wd);
+				watches.erase(w);
+			}
+		}
+	}
+	lru.erase(it->second);
+	index.erase(it);
+}
+
+// Something changed in the directory of watch wd: drop all its entries
+void	OpenFileCache::dropWatch(int wd, bool removed_by_kernel)
+{
+	WatchMap::iterator	w = watches.find(wd);
+
+	if (w == watches.end())
+		return ;	// deja retire (IN_IGNORED apres notre inotify_rm_watch())
+
+	std::set<std::string>	paths;
+	paths.swap(w->second);
+	watches.erase(w);
+	if (!removed_by_kernel)
+		inotify_rm_watch(inotify_fd, wd);
+
+	for (std::set<std::string>::iterator p = paths.begin(); p != paths.end(); ++p)
+	{
+		EntryIndex::iterator	it = index.find(*p);
+		if (it == index.end())
+			continue ;
+		it->second->wd = -1;	// watch deja retire
+		erase(it);
+		stats.invalidations++;
+	}
+}
+
+void	OpenFileCache::clear()
+{
+	stats.invalidations += index.size();
+	for (EntryList::iterator it = lru.begin(); it != lru.end(); ++it)
+	{
+		if (it->fd >= 0)
+			close(it->fd);
+	}
+	for (WatchMap::iterator w = watches.begin(); w != watches.end(); ++w)
+		inotify_rm_watch(inotify_fd, w->first);
+	lru.clear();
+	index.clear();
+	watches.clear();
+}
@@ -1,21 +1,43 @@
 #include "router/PathUtils.hpp"
+#include "router/OpenFileCache.hpp"
 #include <sys/stat.h>
+#include <fcntl.h>
 
 // ---------- helpers ----------
+// Each helper goes through the OpenFileCache of the thread when there is
+// one (Server::run() installs it): the predicates of one request on the
+// same path then cost a single stat()
+
+bool statPath(const std::string& p, struct stat& st)
+{
+	OpenFileCache*	cache = OpenFileCache::current();
+
+	if (cache != NULL)
+		return (cache->stat(p, st));
+	return (stat(p.c_str(), &st) == 0);
+}
+
+static bool accessPath(const std::string& p, int mode)
+{
+	OpenFileCache*	cache = OpenFileCache::current();
+
+	if (cache != NULL)
+		return (cache->access(p, mode));
+	return (access(p.c_str(), mode) == 0);
+}
+
 bool exists(const std::string& p)
 {
 	struct stat st;
 
-	if (stat(p.c_str(), &st) != 0)
-		return (false);
-	return (true);
+	return (statPath(p, st));
 }
 
 bool isDir(const std::string& p)
 {
 	struct stat st;
 
-	if (stat(p.c_str(), &st) != 0)
+	if (!statPath(p, st))
 		return (false);
 	return (S_ISDIR(st.st_mode));
 }
@@ -24,33 +46,62 @@ bool isFile(const std::string& p)
 {
 	struct stat st;
 
-	if (stat(p.c_str(), &st) != 0)
+	if (!statPath(p, st))
 		return (false);
 	return (S_ISREG(st.st_mode));
 }
 
 bool canReadFile(const std::string& p)
 {
-	return (access(p.c_str(), R_OK) == 0);
+	return (accessPath(p, R_OK));
 }
 
 // For directories, X_OK is required to "enter"/traverse.
 // Without X_OK, you can't access contents or files inside.
 bool canTraverseDir(const std::string& p)
 {
-	return (access(p.c_str(), X_OK) == 0);
+	return (accessPath(p, X_OK));
 }
 
 // For autoindex, you also need to be able to read the directory entries.
 // Usually you need BOTH: R_OK (list) and X_OK (traverse).
 bool canListDir(const std::string& p)
 {
-	return (access(p.c_str(), R_OK) == 0 && access(p.c_str(), X_OK) == 0);
+	return (accessPath(p, R_OK | X_OK));
 }
 
 bool canWriteInDir(const std::string& p)
 {
-	return (access(p.c_str(), W_OK) == 0 && access(p.c_str(), X_OK) == 0);
+	return (accessPath(p, W_OK | X_OK));
+}
+
+// Regular file opened read-only (O_CLOEXEC: CGI children must not inherit
+// it), st = its stat. The caller closes the fd. -1 if it cannot be opened
+int openFile(const std::string& p, struct stat& st)
+{
+	OpenFileCache*	cache = OpenFileCache::current();
+
+	if (cache != NULL)
+		return (cache->open(p, st));
+
+	int	fd = open(p.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return (-1);
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		close(fd);
+		return (-1);
+	}
+	return (fd);
+}
+
+// The server changed p itself (upload, DELETE): cached results are stale
+void invalidatePath(const std::string& p)
+{
+	OpenFileCache*	cache = OpenFileCache::current();
+
+	if (cache != NULL)
+		cache->invalidate(p);
 }
 
 // void debugAccessError(const std::string& what, const std::string& path)
@@ -1,14 +1,18 @@
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <unistd.h>
+#include <sys/stat.h>
 #include "utils.hpp"
 #include "http/Mime.hpp"
+#include "http/Status.hpp"
+#include "network/Clock.hpp"
 #include "router/Router.hpp"
 #include "router/PathUtils.hpp"
 #include "cgi/CgiHandler.hpp"
 
-Router::Router(const Config& cfg, const ServerBlock* serverBlock)
-	: cfg(cfg), server(serverBlock), rules(NULL) {}
+Router::Router(const Config& cfg, const ServerBlock* serverBlock, FileCache* fileCache)
+	: cfg(cfg), server(serverBlock), rules(NULL), fileCache(fileCache), request(NULL) {}
 
 Router::~Router() {}
 
@@ -119,6 +123,18 @@ bool	Router::exceedsMaxSize(const size_t& len)
 	return (false);
 }
 
+/**
+ * @brief Size checked against clientMaxBodySize: the announced
+ * Content-Length (known before the body, see planBody()), otherwise the
+ * bytes received (chunked).
+ */
+size_t	Router::bodySize(const HttpRequest& req)
+{
+	if (req.hasContentLength)
+		return (req.contentLength);
+	return (req.bodyBytesRead);
+}
+
 
 
 // helper function to read file into string
@@ -140,6 +156,163 @@ bool	Router::readFileToString(const std::string& path, std::string& responseBody
 	return (true);
 }
 
+/**
+ * @brief Opens path as the body of resp, without reading it: the
+ * Connection sends it with sendfile() (kernel to socket, no copy in
+ * memory, whatever the size of the file). Small files are read once into
+ * the file cache instead, when it is on (see fromFileCache()).
+ * @return false if the file cannot be opened or is not a regular file
+ */
+bool	Router::openFileBody(const std::string& path, HttpResponse& resp)
+{
+	struct stat	st;
+	int			fd = openFile(path, st);	// cached fd + stat with open_file_cache
+
+	if (fd < 0)
+		return (false);
+	const FileCache::Entry*	cached = (fileCache != NULL) ? fileCache->insert(path, fd, st) : NULL;
+	if (cached != NULL)
+	{
+		close(fd);
+		resp.prebuilt = cached->response;
+		return (true);
+	}
+	resp.headers["Content-Type"] = Mime::fromPath(path);
+	resp.headers["ETag"] = FileCache::makeETag(st);
+	resp.headers["Last-Modified"] = FileCache::makeLastModified(st);
+	resp.body.clear();
+	resp.bodyFd = fd;
+	resp.bodyOffset = 0;
+	resp.bodyLength = static_cast<size_t>(st.st_size);
+	return (true);
+}
+
+// 304: the validators the 200 would have had, no body (RFC 9110 15.4.5)
+static HttpResponse	notModifiedResponse(const std::string& etag, const std::string& lastModified)
+{
+	HttpResponse	resp(304, reasonPhrase(304));
+
+	resp.headers["ETag"] = etag;
+	resp.headers["Last-Modified"] = lastModified;
+	return (resp);
+}
+
+/**
+ * @brief Fills resp from the file cache if path is a cached regular file
+ * that did not change since it was read: one stat() (none with
+ * open_file_cache), no open()/read().
+ * The entry was readable when cached and its ctime has not moved since
+ * (no chmod), so the access() checks of the GET path are not needed.
+ * @return false on a miss: the caller takes the filesystem path
+ */
+bool	Router::fromFileCache(const std::string& path, HttpResponse& resp)
+{
+	struct stat	st;
+
+	if (fileCache == NULL || !statPath(path, st) || !S_ISREG(st.st_mode))
+		return (false);
+
+	const FileCache::Entry*	cached = fileCache->lookup(path, st);
+	if (cached == NULL)
+		return (false);
+	if (notModified(cached->etag, cached->st.st_mtime))
+	{
+		resp = notModifiedResponse(cached->etag, cached->lastModified);
+		return (true);
+	}
+	resp.prebuilt = cached->response;	// en-tetes et body deja serialises
+	return (true);
+}
+
+/*
+	If-None-Match: true if one of the entity tags of the list matches etag,
+	or the list is "*". Weak comparison (RFC 9110 8.8.3.2, the one for
+	GET): a W/ prefix is ignored on both sides.
+*/
+static bool	etagListMatches(const HeaderView& list, const std::string& etag)
+{
+	size_t	skip = (etag.compare(0, 2, "W/") == 0) ? 2 : 0;
+	size_t	i = 0;
+
+	while (i < list.size)
+	{
+		char	c = list.data[i];
+
+		if (c == ' ' || c == '\t' || c == ',')
+		{
+			++i;
+			continue ;
+		}
+		if (c == '*')
+			return (true);
+		if (c == 'W' && i + 1 < list.size && list.data[i + 1] == '/')
+			i += 2;
+		if (i < list.size && list.data[i] == '"')
+		{
+			const char	*close = static_cast<const char *>(
+				std::memchr(list.data + i + 1, '"', list.size - i - 1));
+			if (close == NULL)
+				return (false);	// tag non termine: liste invalide
+			size_t	len = close - (list.data + i) + 1;	// avec les guillemets
+			if (len == etag.size() - skip
+				&& etag.compare(skip, len, list.data + i, len) == 0)
+				return (true);
+			i += len;
+			continue ;
+		}
+		// Pas un entity-tag: jusqu'a la virgule suivante
+		while (i < list.size && list.data[i] != ',')
+			++i;
+	}
+	return (false);
+}
+
+/**
+ * @brief Conditional GET (RFC 9110 13.2.2): true if the request already has
+ * this version of the file, the response is then a 304 without body.
+ * If-None-Match decides when present (If-Modified-Since is then ignored),
+ * else If-Modified-Since: not modified if mtime <= its date. An invalid
+ * date is ignored.
+ */
+bool	Router::notModified(const std::string& etag, time_t mtime) const
+{
+	if (request == NULL)
+		return (false);
+
+	HeaderView	inm = request->headers.get(HeaderTable::H_IF_NONE_MATCH);
+	if (inm.present())
+		return (etagListMatches(inm, etag));
+
+	HeaderView	ims = request->headers.get(HeaderTable::H_IF_MODIFIED_SINCE);
+	time_t		since;
+	if (ims.present() && Clock::parseHttpDate(ims.data, ims.size, since))
+		return (mtime <= since);
+	return (false);
+}
+
+/**
+ * @brief 304 for the regular file path, from its stat() (cached with
+ * open_file_cache): the file is not opened. Only for requests with
+ * validators, the others go straight to openFileBody().
+ * @return false if the response is not a 304
+ */
+bool	Router::notModifiedFile(const std::string& path, HttpResponse& resp)
+{
+	struct stat	st;
+
+	if (request == NULL || (!request->headers.has(HeaderTable::H_IF_NONE_MATCH)
+			&& !request->headers.has(HeaderTable::H_IF_MODIFIED_SINCE)))
+		return (false);
+	if (!statPath(path, st) || !S_ISREG(st.st_mode))
+		return (false);
+
+	std::string	etag = FileCache::makeETag(st);
+	if (!notModified(etag, st.st_mtime))
+		return (false);
+	resp = notModifiedResponse(etag, FileCache::makeLastModified(st));
+	return (true);
+}
+
 
 
 HttpResponse	Router::buildRedirectResponse(const int& code, const std::string& target)
@@ -191,6 +364,8 @@ bool	Router::isCgiRequest(const HttpRequest& req) const
 HttpResponse	Router::routing(const HttpRequest& req)
 {
 
+	request = &req;
+
 // Find correct context for requestURI
 	getLocation(req.path);
 	if (!rules)// should never happen, defensive coding
@@ -204,7 +379,7 @@ HttpResponse	Router::routing(const HttpRequest& req)
 // ==========================================================================
 	if (isCgiRequest(req))
 	{
-		if (exceedsMaxSize(req.body.size()))
+		if (exceedsMaxSize(bodySize(req)))
 			return (HttpResponse(413, "Payload Too Large"));
 
 		// Build the filesystem path //location /cgi-bin { root .; cgi_extension .py; } /cgi-bin/form.py → ./cgi-bin/form.py
@@ -241,7 +416,7 @@ HttpResponse	Router::routing(const HttpRequest& req)
 	if (!methodAllowed(req.method))
 		return (HttpResponse(405, "Method Not Allowed"));
 
-	if (exceedsMaxSize(req.body.size()))//changed to bodySize to handle chunked requests
+	if (exceedsMaxSize(bodySize(req)))//not body.size(): the body may have been streamed to a file
 		return (HttpResponse(413, "Payload Too Large"));
 
 // Split logic to handle GET, DELETE and POST separately
@@ -258,6 +433,58 @@ HttpResponse	Router::routing(const HttpRequest& req)
 }
 
 
+/**
+ * @brief Chooses where the body of req goes, from its headers only
+ * (called by the Server before the body is read).
+ * @note Follows the same order as routing(). Whatever routing() answers
+ * from the headers alone (redirect, 405, 404, 413 on Content-Length,
+ * upload errors) gets BODY_REJECT: the Server sends that answer without
+ * waiting for the body. Bodies the response ignores (GET, DELETE) get
+ * BODY_DISCARD. Anything unsure falls back to BODY_MEMORY, so that
+ * routing() behaves as before. The size limit of a chunked body is
+ * enforced by the parser while the body arrives.
+ */
+BodyPlan	Router::planBody(const HttpRequest& req)
+{
+	BodyPlan	plan;
+
+	getLocation(req.path);
+	if (!rules)
+		return (plan);
+	plan.maxBodySize = rules->clientMaxBodySize;
+
+	if (isCgiRequest(req))
+	{
+		plan.path = getResolvedPath(req.path, *rules);
+		if (exceedsMaxSize(bodySize(req)) || access(plan.path.c_str(), F_OK) != 0)
+			plan.target = BodyPlan::BODY_REJECT;	// 413 / 404
+		// CONTENT_LENGTH must be known when the CGI starts: chunked bodies
+		// are read first, as before
+		else if (req.hasContentLength)
+			plan.target = BodyPlan::BODY_CGI;
+		return (plan);
+	}
+
+	if (rules->hasRedirect || !methodAllowed(req.method) || exceedsMaxSize(bodySize(req)))
+	{
+		plan.target = BodyPlan::BODY_REJECT;
+		return (plan);
+	}
+	if (req.method != METHOD_POST)
+	{
+		plan.target = BodyPlan::BODY_DISCARD;
+		return (plan);
+	}
+
+	std::string	filename;
+	if (uploadTarget(req, filename, plan.path).statusCode != 0)
+		plan.target = BodyPlan::BODY_REJECT;		// 400/403/500 from handlePost()
+	else
+		plan.target = BodyPlan::BODY_UPLOAD_FILE;
+	return (plan);
+}
+
+
 HttpResponse Router::buildResponse(const HttpRequest& req)
 {
 	//Kept HttpResponse as may need Location pointer for POST so we can provide the path of where the upload occured
@@ -266,7 +493,7 @@ HttpResponse Router::buildResponse(const HttpRequest& req)
 
 	if (result.isCgiPending && result.statusCode == 0)
 		return (result);
-	if (result.isSuccess())
+	if (result.isSuccess() || result.statusCode == 304)
 		printSuccess(result);
 	else if (result.isRedirect)
 		printRedirect(result);
@@ -41,6 +41,7 @@ HttpResponse	Router::handleDelete(const std::string& urlPath)
 
 	if (unlink(resolvedPath.c_str()) != 0)
 		return (HttpResponse(500, "Internal Server Error"));
+	invalidatePath(resolvedPath);
 
 	return (HttpResponse(204, "No Content"));
 }
@@ -12,7 +12,7 @@
  * improve readability and maintainability.
  *
  * Some helpers take a `Router& self` parameter because they need to call
- * Router member functions (e.g. readFileToString), while remaining non-member
+ * Router member functions (e.g. openFileBody), while remaining non-member
  * helpers local to this .cpp file.
  *
  * This preserves Router ownership of core logic while keeping helpers
@@ -31,7 +31,7 @@ static HttpResponse	getNotFound(const std::string& resolvedPath)
 
 HttpResponse Router::getServeFile( const std::string& resolvedPath)
 {
-	std::string body;
+	HttpResponse	resp(200, "OK");
 
 	// std::cout << YELLOW << "[DEBUG - GET] " << GREEN
 	// 		  << "Path links to file" << RES << std::endl;
@@ -45,8 +45,13 @@ HttpResponse Router::getServeFile( const std::string& resolvedPath)
 		return (HttpResponse(403, "Forbidden"));
 	}
 
-	// Actual read (even if access() said OK, open() can still fail)
-	if (!readFileToString(resolvedPath, body))
+	// Conditional GET: the client has this version, 304 without opening it
+	if (notModifiedFile(resolvedPath, resp))
+		return (resp);
+
+	// Actual open (even if access() said OK, open() can still fail).
+	// Not read here: sent with sendfile() by the Connection
+	if (!openFileBody(resolvedPath, resp))
 	{
 		std::cout << YELLOW << "[DEBUG - GET] " << ORANGE
 				  << "Failed reading file despite R_OK: " << RES
@@ -54,7 +59,7 @@ HttpResponse Router::getServeFile( const std::string& resolvedPath)
 		return (HttpResponse(500, "Internal Server Error"));
 	}
 
-	return (HttpResponse(200, "OK", body));
+	return (resp);
 }
 
 
@@ -73,8 +78,6 @@ static bool	needsDirRedirect(const std::string& requestedPath)
 HttpResponse Router::getTryIndexFiles(const std::string& resolvedPath,
 	const std::vector<std::string>& indexList)
 {
-	std::string body;
-
 	// Try index files (index lookup requires traversable dir; file itself must be readable)
 	for (size_t i = 0; i < indexList.size(); ++i)
 	{
@@ -83,6 +86,10 @@ HttpResponse Router::getTryIndexFiles(const std::string& resolvedPath,
 		// std::cout << YELLOW << "[DEBUG - GET] " << RES
 		// 		  << "Trying index file: " << PURPLE << candidate << RES << std::endl;
 
+		HttpResponse	cached(200, "OK");
+		if (fromFileCache(candidate, cached))
+			return (cached);
+
 		if (isFile(candidate))
 		{
 			if (!canReadFile(candidate))
@@ -90,9 +97,12 @@ HttpResponse Router::getTryIndexFiles(const std::string& resolvedPath,
 				// debugAccessError("READ index file", candidate);
 				return (HttpResponse(403, "Forbidden"));
 			}
-			if (!readFileToString(candidate, body))
+			HttpResponse	resp(200, "OK");
+			if (notModifiedFile(candidate, resp))
+				return (resp);
+			if (!openFileBody(candidate, resp))
 				return (HttpResponse(403, "Forbidden"));
-			return (HttpResponse(200, "OK", body));
+			return (resp);
 		}
 	}
 
@@ -167,6 +177,11 @@ HttpResponse Router::handleGet(const std::string& requestedPath)
 	// 		  << "ResolvedPath: " << resolvedPath
 	// 		  << RES << std::endl;
 
+	// 0) Hot file: from the file cache, without open()/read() (304 included)
+	HttpResponse	cached(200, "OK");
+	if (fromFileCache(resolvedPath, cached))
+		return (cached);
+
 	// 1) Not found
 	if (!exists(resolvedPath))
 		return (getNotFound(resolvedPath));
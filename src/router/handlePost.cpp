@@ -50,13 +50,14 @@ static std::string lastPathSegmentOrEmpty(const std::string& urlPath)
 
 static std::string generateUploadName()
 {
+	// Partage entre les reactors (worker_threads): increment atomique
 	static unsigned long counter = 0;
-	++counter;
+	unsigned long n = __sync_add_and_fetch(&counter, 1);
 
 	//Unix epoch seconds
 	std::time_t t = std::time(NULL);
 	std::ostringstream oss;
-	oss << "upload_file_" << (unsigned long)t << "_" << counter << ".bin";
+	oss << "upload_file_" << (unsigned long)t << "_" << n << ".bin";
 	return (oss.str());
 }
 
@@ -126,14 +127,15 @@ static HttpResponse	writeBodyToFileOrFail(const std::string& fullPath,
 }
 
 
-/*@note It will upload anything (PNG/JPG/PDF/ZIP…), as long as the client
- sends the body as raw bytes (like  with --data-binary )
- printf 'hello\n' | curl -v -X POST --data-binary @- http://127.0.0.1:8080/upload/hello.txt),
-because its writen in binary mode*/
-HttpResponse Router::handlePost(const HttpRequest& req)
+/**
+ * @brief Steps 3-8 of handlePost(): where the body of req must be written.
+ * @note Also used by planBody() to stream the body to that file while it
+ * arrives. A generated name is only decided once: handlePost() then reuses
+ * req.uploadPath.
+ * @return statusCode 0 when filename/fullPath are set, the error otherwise
+ */
+HttpResponse	Router::uploadTarget(const HttpRequest& req, std::string& filename, std::string& fullPath)
 {
-	//1-5 Dibran CGI bypassed already in routing()
-
 	// 3-5) Validate upload dir
 	// {} limits the lifetime (scope) of err
 	{
@@ -143,7 +145,7 @@ HttpResponse Router::handlePost(const HttpRequest& req)
 	}
 
 	// 6) Decide filename:
-	std::string filename = lastPathSegmentOrEmpty(req.path);
+	filename = lastPathSegmentOrEmpty(req.path);
 
 	// Edge case: POST to exactly the location URI
 	if (req.path == rules->uri)
@@ -157,18 +159,53 @@ HttpResponse Router::handlePost(const HttpRequest& req)
 		return (HttpResponse(400, "Bad Request"));
 
 	// 8) Full filesystem path
-	std::string fullPath = joinPath(rules->uploadDir, filename);
+	fullPath = joinPath(rules->uploadDir, filename);
+	return (HttpResponse(0, "")); // sentinel OK
+}
+
+
+/*@note It will upload anything (PNG/JPG/PDF/ZIP…), as long as the client
+ sends the body as raw bytes (like  with --data-binary )
+ printf 'hello\n' | curl -v -X POST --data-binary @- http://127.0.0.1:8080/upload/hello.txt),
+because its writen in binary mode*/
+HttpResponse Router::handlePost(const HttpRequest& req)
+{
+	//1-5 Dibran CGI bypassed already in routing()
 
-	// Track whether it existed (optional; choose a response policy)
-	bool existedBefore = exists(fullPath);
+	std::string	filename;
+	std::string	fullPath;
+	bool		existedBefore;
 
-	// 9) Write bytes
+	if (!req.uploadPath.empty())
 	{
-		HttpResponse err = writeBodyToFileOrFail(fullPath, req);
-		if (err.statusCode != 0)
-			return (err);
+		// Body already streamed to the file chosen by planBody() (FileBodySink)
+		fullPath = req.uploadPath;
+		filename = lastPathSegmentOrEmpty(fullPath);
+		existedBefore = req.uploadExisted;
+	}
+	else
+	{
+		// 3-8) Validate upload dir, decide filename and path
+		{
+			HttpResponse err = uploadTarget(req, filename, fullPath);
+			if (err.statusCode != 0)
+				return (err);
+		}
+
+		// Track whether it existed (optional; choose a response policy)
+		existedBefore = exists(fullPath);
+
+		// 9) Write bytes
+		{
+			HttpResponse err = writeBodyToFileOrFail(fullPath, req);
+			if (err.statusCode != 0)
+				return (err);
+		}
 	}
 
+	// The file changed: a GET right after must not see a cached stat()
+	invalidatePath(fullPath);
+
 	// 10) Build response
 	/*
 	Choose ONE policy ::